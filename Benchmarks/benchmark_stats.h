@@ -0,0 +1,66 @@
+#pragma once
+
+//std
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace vt {
+
+    // Order statistics of a set of timings, in the unit they were measured in.
+    struct BenchmarkSummary {
+        double mean = 0.0;
+        double min = 0.0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    // Nearest-rank percentile of an already sorted sample, _percent in [0, 100].
+    inline double percentile(const std::vector<double>& _sorted, double _percent) {
+        if (_sorted.empty()) {
+            return 0.0;
+        }
+        size_t rank = static_cast<size_t>(std::ceil(_percent / 100.0 * static_cast<double>(_sorted.size())));
+        return _sorted[std::min(_sorted.size() - 1, rank == 0 ? 0 : rank - 1)];
+    }
+
+    inline BenchmarkSummary summarize(std::vector<double> _samples) {
+        BenchmarkSummary summary{};
+        if (_samples.empty()) {
+            return summary;
+        }
+
+        std::sort(_samples.begin(), _samples.end());
+        summary.mean = std::accumulate(_samples.begin(), _samples.end(), 0.0) / static_cast<double>(_samples.size());
+        summary.min = _samples.front();
+        summary.p50 = percentile(_samples, 50.0);
+        summary.p95 = percentile(_samples, 95.0);
+        summary.p99 = percentile(_samples, 99.0);
+        summary.max = _samples.back();
+        return summary;
+    }
+
+    inline void writeJson(std::ostream& _out, const BenchmarkSummary& _summary) {
+        _out << "{\"mean\":" << _summary.mean << ",\"min\":" << _summary.min << ",\"p50\":" << _summary.p50
+            << ",\"p95\":" << _summary.p95 << ",\"p99\":" << _summary.p99 << ",\"max\":" << _summary.max << "}";
+    }
+
+    // Quotes and escapes _value as a JSON string.
+    inline std::string jsonString(const std::string& _value) {
+        std::string quoted = "\"";
+        for (char c : _value) {
+            if (c == '"' || c == '\\') {
+                quoted += '\\';
+            }
+            if (static_cast<unsigned char>(c) >= 0x20) {
+                quoted += c;
+            }
+        }
+        return quoted + "\"";
+    }
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "vt_visibility_culler.h"
+#include "benchmark_stats.h"
+
+//std
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Microbenchmark for VtVisibilityCuller, written as JSON:
+//
+//   culling_benchmark [--repeats <n>] [--output <file>]
+//
+// Every kernel the CPU supports culls the same random scenes, with under a tenth of the objects in
+// view. Each kernel's visible list is checked against the scalar one before its time is reported.
+
+namespace {
+
+    constexpr uint32_t SEED = 1234;
+
+    void buildScene(vt::VtVisibilityCuller& _culler, uint32_t _objectCount) {
+        std::mt19937 random{ SEED };
+        std::uniform_real_distribution<float> position{ -4.0f, 4.0f };
+        std::uniform_real_distribution<float> extent{ 0.01f, 0.5f };
+
+        _culler.resize(_objectCount);
+        for (uint32_t i = 0; i < _objectCount; i++) {
+            glm::vec2 min{ position(random), position(random) };
+            _culler.setBounds(i, min, glm::vec2{ min.x + extent(random), min.y + extent(random) });
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t repeats = 50;
+    std::string outputPath = "culling_benchmark.json";
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--repeats") == 0 && i + 1 < argc) {
+            repeats = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        }
+        else {
+            std::cerr << "usage: " << argv[0] << " [--repeats <n>] [--output <file>]" << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (repeats == 0) {
+        std::cerr << "--repeats must be at least 1" << '\n';
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream output{ outputPath, std::ios::trunc };
+    if (!output.is_open()) {
+        std::cerr << "Failed to open file: " << outputPath << '\n';
+        return EXIT_FAILURE;
+    }
+
+    const vt::VtVisibilityCuller::Rect view{ { -1.0f, -1.0f }, { 1.0f, 1.0f } };
+    const vt::VtVisibilityCuller::Kernel kernels[] = {
+        vt::VtVisibilityCuller::Kernel::Scalar,
+        vt::VtVisibilityCuller::Kernel::Sse2,
+        vt::VtVisibilityCuller::Kernel::Avx };
+
+    bool firstResult = true;
+    output << "{\"repeats\":" << repeats << ",\"results\":[";
+
+    for (uint32_t objectCount : { 1000u, 10000u, 100000u, 1000000u }) {
+        vt::VtVisibilityCuller culler{};
+        buildScene(culler, objectCount);
+
+        culler.setKernel(vt::VtVisibilityCuller::Kernel::Scalar);
+        culler.cull(view);
+        std::vector<uint32_t> expected(culler.getVisible(), culler.getVisible() + culler.getVisibleCount());
+
+        for (auto kernel : kernels) {
+            if (!vt::VtVisibilityCuller::isSupported(kernel)) {
+                continue;
+            }
+            std::cerr << "culling " << objectCount << " objects with " << vt::VtVisibilityCuller::kernelName(kernel) << '\n';
+
+            culler.setKernel(kernel);
+            std::vector<double> samples;
+            for (uint32_t i = 0; i < repeats; i++) {
+                auto start = std::chrono::steady_clock::now();
+                culler.cull(view);
+                samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            }
+
+            std::vector<uint32_t> visible(culler.getVisible(), culler.getVisible() + culler.getVisibleCount());
+            if (visible != expected) {
+                std::cerr << vt::VtVisibilityCuller::kernelName(kernel) << " disagrees with the scalar kernel" << '\n';
+                return EXIT_FAILURE;
+            }
+
+            output << (firstResult ? "\n" : ",\n");
+            firstResult = false;
+            output << "{\"kernel\":" << vt::jsonString(vt::VtVisibilityCuller::kernelName(kernel))
+                << ",\"objectCount\":" << objectCount
+                << ",\"visibleCount\":" << visible.size()
+                << ",\"timeMs\":";
+            vt::writeJson(output, vt::summarize(samples));
+            output << "}";
+        }
+    }
+
+    output << "\n]}\n";
+    std::cerr << "wrote " << outputPath << '\n';
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include "first_app.h"
+#include "benchmark_stats.h"
+
+//std
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+// Runs a sweep of headless scenes through FirstApp and writes per-scene frame statistics as JSON:
+//
+//   frame_benchmark [--frames <n>] [--warmup <n>] [--filter <substring>] [--output <file>]
+//                   [--frames-in-flight <n>] [--image-count <n>] [--present-mode <mode>] [--timeline] [--transient-depth]
+//                   [--windowed]
+//
+// Every scene gets a fresh device so peak device memory and pipeline state do not leak between scenes.
+// The host's peak resident set never resets within a process, so it is reported once for the whole run.
+// The frame settings apply to every scene; run once per configuration to compare them. The present
+// mode only matters with --windowed, headless runs have nothing to present to.
+
+namespace {
+
+    struct Scene {
+        std::string name;
+        int sierpinskiDepth;
+        uint32_t objectCount;
+        bool instanced;
+        bool gpuGeometry = false;
+        bool gpuCulling = false;
+        bool cpuCulling = false;
+        vt::VtVertexFormat vertexFormat = vt::VtVertexFormat::Float;
+    };
+
+    std::vector<Scene> buildScenes() {
+        std::vector<Scene> scenes;
+
+        // Geometry sweep: one draw of an ever denser mesh, built on the CPU in every vertex format or
+        // by a compute shader.
+        for (int depth = 1; depth <= 10; depth++) {
+            scenes.push_back({ "sierpinski_depth" + std::to_string(depth), depth, 1, false });
+            for (auto format : { vt::VtVertexFormat::Snorm16, vt::VtVertexFormat::Half }) {
+                Scene scene{ "sierpinski_depth" + std::to_string(depth) + "_" + vt::vertexFormatName(format), depth, 1, false };
+                scene.vertexFormat = format;
+                scenes.push_back(scene);
+            }
+            scenes.push_back({ "sierpinski_depth" + std::to_string(depth) + "_gpu", depth, 1, false, true });
+        }
+
+        // Draw count sweep: many copies of a single triangle, one draw each, one instanced draw, either
+        // of those after CPU culling, or culled on the GPU into one indirect draw.
+        for (uint32_t objects : { 1u, 10u, 100u, 1000u, 10000u, 100000u }) {
+            scenes.push_back({ "objects" + std::to_string(objects) + "_push_constants", 0, objects, false });
+            scenes.push_back({ "objects" + std::to_string(objects) + "_instanced", 0, objects, true });
+            scenes.push_back({ "objects" + std::to_string(objects) + "_push_constants_cpu_culled", 0, objects, false, false, false, true });
+            scenes.push_back({ "objects" + std::to_string(objects) + "_instanced_cpu_culled", 0, objects, true, false, false, true });
+            scenes.push_back({ "objects" + std::to_string(objects) + "_gpu_culled", 0, objects, false, false, true });
+        }
+
+        return scenes;
+    }
+
+    // Peak resident set of the whole process so far, in bytes; 0 where the platform has no getrusage.
+    uint64_t peakHostMemory() {
+#if defined(__unix__) || defined(__APPLE__)
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+        return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+        return 0;
+#endif
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t measuredFrames = 300;
+    uint32_t warmupFrames = 60;
+    std::string filter;
+    std::string outputPath = "benchmark_results.json";
+    vt::VtFrameSettings frameSettings{};
+    bool windowed = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            measuredFrames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmupFrames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--frames-in-flight") == 0 && i + 1 < argc) {
+            frameSettings.framesInFlight = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--image-count") == 0 && i + 1 < argc) {
+            frameSettings.imageCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--present-mode") == 0 && i + 1 < argc && vt::parsePresentMode(argv[i + 1], frameSettings.presentMode)) {
+            i++;
+        }
+        else if (std::strcmp(argv[i], "--timeline") == 0) {
+            frameSettings.useTimelineSemaphores = true;
+        }
+        else if (std::strcmp(argv[i], "--transient-depth") == 0) {
+            frameSettings.useTransientDepth = true;
+        }
+        else if (std::strcmp(argv[i], "--windowed") == 0) {
+            windowed = true;
+        }
+        else {
+            std::cerr << "usage: " << argv[0] << " [--frames <n>] [--warmup <n>] [--filter <substring>] [--output <file>]"
+                << " [--frames-in-flight <n>] [--image-count <n>] [--present-mode fifo|fifo-relaxed|mailbox|immediate] [--timeline] [--transient-depth] [--windowed]" << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (measuredFrames == 0) {
+        std::cerr << "--frames must be at least 1" << '\n';
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream output{ outputPath, std::ios::trunc };
+    if (!output.is_open()) {
+        std::cerr << "Failed to open file: " << outputPath << '\n';
+        return EXIT_FAILURE;
+    }
+
+    std::string deviceName;
+    bool firstScene = true;
+    output << "{\"measuredFrames\":" << measuredFrames << ",\"warmupFrames\":" << warmupFrames
+        << ",\"windowed\":" << (windowed ? "true" : "false")
+        << ",\"framesInFlight\":" << frameSettings.framesInFlight
+        << ",\"imageCount\":" << frameSettings.imageCount
+        << ",\"timelineSemaphores\":" << (frameSettings.useTimelineSemaphores ? "true" : "false")
+        << ",\"transientDepth\":" << (frameSettings.useTransientDepth ? "true" : "false")
+        << ",\"presentMode\":" << vt::jsonString(vt::presentModeName(frameSettings.presentMode))
+        << ",\"scenes\":[";
+
+    try {
+        for (const auto& scene : buildScenes()) {
+            if (!filter.empty() && scene.name.find(filter) == std::string::npos) {
+                continue;
+            }
+            std::cerr << "running " << scene.name << '\n';
+
+            vt::AppSettings settings{};
+            settings.headless = !windowed;
+            settings.frameCount = warmupFrames + measuredFrames;
+            settings.sierpinskiDepth = scene.sierpinskiDepth;
+            settings.objectCount = scene.objectCount;
+            settings.useInstancing = scene.instanced;
+            settings.generateOnGpu = scene.gpuGeometry;
+            settings.useGpuCulling = scene.gpuCulling;
+            settings.useCpuCulling = scene.cpuCulling;
+            settings.vertexFormat = scene.vertexFormat;
+            settings.frame = frameSettings;
+
+            vt::FirstApp app{ settings };
+            app.run();
+            deviceName = app.getDevice().properties.deviceName;
+
+            // Drop the warm-up frames, they include upload retirement and first-use driver work.
+            const auto& timings = app.getTimings();
+            auto measured = [&](const auto& _samples) {
+                size_t skip = std::min<size_t>(warmupFrames, _samples.size());
+                return std::decay_t<decltype(_samples)>(_samples.begin() + skip, _samples.end());
+            };
+            std::vector<double> frameTimes = measured(timings.frameMilliseconds);
+            std::vector<double> recordTimes = measured(timings.recordMilliseconds);
+            std::vector<double> latencies = measured(timings.latencyMilliseconds);
+            std::vector<uint64_t> triangles = measured(timings.trianglesSubmitted);
+
+            double totalSeconds = 0.0;
+            for (double frameTime : frameTimes) {
+                totalSeconds += frameTime / 1000.0;
+            }
+            // Culled scenes draw fewer triangles than they hold, so count what each frame actually submitted.
+            uint64_t totalTriangles = 0;
+            for (uint64_t frameTriangles : triangles) {
+                totalTriangles += frameTriangles;
+            }
+            double trianglesPerFrame = triangles.empty() ? 0.0 : static_cast<double>(totalTriangles) / static_cast<double>(triangles.size());
+            double trianglesPerSecond = totalSeconds > 0.0 ? static_cast<double>(totalTriangles) / totalSeconds : 0.0;
+
+            output << (firstScene ? "\n" : ",\n");
+            firstScene = false;
+            output << "{\"name\":" << vt::jsonString(scene.name)
+                << ",\"sierpinskiDepth\":" << scene.sierpinskiDepth
+                << ",\"objectCount\":" << scene.objectCount
+                << ",\"instanced\":" << (scene.instanced ? "true" : "false")
+                << ",\"gpuGeometry\":" << (scene.gpuGeometry ? "true" : "false")
+                << ",\"vertexFormat\":" << vt::jsonString(vt::vertexFormatName(scene.vertexFormat))
+                << ",\"gpuCulling\":" << (scene.gpuCulling ? "true" : "false")
+                << ",\"cpuCulling\":" << (scene.cpuCulling ? "true" : "false")
+                << ",\"modelLoadMs\":" << app.getModelLoadMilliseconds()
+                << ",\"trianglesPerFrame\":" << trianglesPerFrame
+                << ",\"frameTimeMs\":";
+            vt::writeJson(output, vt::summarize(frameTimes));
+            output << ",\"cpuRecordTimeMs\":";
+            vt::writeJson(output, vt::summarize(recordTimes));
+            output << ",\"latencyMs\":";
+            vt::writeJson(output, vt::summarize(latencies));
+            output << ",\"trianglesPerSecond\":" << trianglesPerSecond
+                << ",\"peakDeviceMemoryBytes\":" << app.getDevice().getMemoryStats().peakReservedBytes
+                << "}";
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    output << "\n],\"peakHostMemoryBytes\":" << peakHostMemory() << ",\"device\":" << vt::jsonString(deviceName) << "}\n";
+    std::cerr << "wrote " << outputPath << '\n';
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "vt_job_system.h"
+#include "benchmark_stats.h"
+
+//std
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Microbenchmarks for VtJobSystem, written as JSON:
+//
+//   job_system_benchmark [--repeats <n>] [--output <file>]
+//
+// spawn:    cost per empty job spawned from the main thread and waited on, in nanoseconds
+// chain:    cost per job in a chain where each job depends on the previous one, in nanoseconds
+// scaling:  parallelFor over a fixed compute-bound workload for 0, 1, 2, 4, ... workers, always ending
+//           at hardware threads - 1
+
+namespace {
+
+    constexpr uint32_t SPAWN_JOBS = 100000;
+    constexpr uint32_t CHAIN_JOBS = 10000;
+    constexpr uint32_t SCALING_ELEMENTS = 1 << 22;
+    constexpr uint32_t SCALING_GRAIN = 1 << 14;
+
+    double elapsedMilliseconds(std::chrono::steady_clock::time_point _start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count();
+    }
+
+    double spawnNanosecondsPerJob(vt::VtJobSystem& _jobs) {
+        vt::VtJobCounter counter;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < SPAWN_JOBS; i++) {
+            _jobs.spawn(counter, []() {});
+        }
+        _jobs.wait(counter);
+        return elapsedMilliseconds(start) * 1e6 / SPAWN_JOBS;
+    }
+
+    double chainNanosecondsPerJob(vt::VtJobSystem& _jobs) {
+        std::vector<vt::VtJobCounter> counters(CHAIN_JOBS);
+        auto start = std::chrono::steady_clock::now();
+        _jobs.spawn(counters[0], []() {});
+        for (uint32_t i = 1; i < CHAIN_JOBS; i++) {
+            _jobs.spawnAfter(counters[i - 1], counters[i], []() {});
+        }
+        for (auto& counter : counters) {
+            _jobs.wait(counter);
+        }
+        return elapsedMilliseconds(start) * 1e6 / CHAIN_JOBS;
+    }
+
+    double scalingMilliseconds(vt::VtJobSystem& _jobs, std::vector<float>& _output) {
+        auto start = std::chrono::steady_clock::now();
+        _jobs.parallelFor(0, SCALING_ELEMENTS, SCALING_GRAIN, [&](uint32_t _begin, uint32_t _end) {
+            for (uint32_t i = _begin; i < _end; i++) {
+                float x = static_cast<float>(i);
+                _output[i] = std::sqrt(x) * std::sin(x) + std::cos(x * 0.5f);
+            }
+        });
+        return elapsedMilliseconds(start);
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t repeats = 20;
+    std::string outputPath = "job_system_benchmark.json";
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--repeats") == 0 && i + 1 < argc) {
+            repeats = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        }
+        else {
+            std::cerr << "usage: " << argv[0] << " [--repeats <n>] [--output <file>]" << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (repeats == 0) {
+        std::cerr << "--repeats must be at least 1" << '\n';
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream output{ outputPath, std::ios::trunc };
+    if (!output.is_open()) {
+        std::cerr << "Failed to open file: " << outputPath << '\n';
+        return EXIT_FAILURE;
+    }
+
+    uint32_t maxWorkers = vt::VtJobSystem::defaultWorkerCount();
+    output << "{\"repeats\":" << repeats << ",\"hardwareThreads\":" << maxWorkers + 1;
+
+    try {
+        {
+            vt::VtJobSystem jobs{};
+            std::vector<double> spawnSamples;
+            std::vector<double> chainSamples;
+            for (uint32_t i = 0; i < repeats; i++) {
+                spawnSamples.push_back(spawnNanosecondsPerJob(jobs));
+                chainSamples.push_back(chainNanosecondsPerJob(jobs));
+            }
+            output << ",\"workers\":" << jobs.workerCount() << ",\"spawnNsPerJob\":";
+            vt::writeJson(output, vt::summarize(spawnSamples));
+            output << ",\"chainNsPerJob\":";
+            vt::writeJson(output, vt::summarize(chainSamples));
+        }
+
+        std::vector<float> scalingOutput(SCALING_ELEMENTS);
+        double baseline = 0.0;
+        output << ",\"scaling\":[";
+        for (uint32_t workers = 0;; workers = workers == 0 ? 1 : std::min(workers * 2, maxWorkers)) {
+            std::cerr << "scaling with " << workers << " workers" << '\n';
+
+            vt::VtJobSystem jobs{ workers };
+            std::vector<double> samples;
+            for (uint32_t i = 0; i < repeats; i++) {
+                samples.push_back(scalingMilliseconds(jobs, scalingOutput));
+            }
+            vt::BenchmarkSummary summary = vt::summarize(samples);
+            if (workers == 0) {
+                baseline = summary.p50;
+            }
+
+            output << (workers == 0 ? "\n" : ",\n") << "{\"workers\":" << workers << ",\"timeMs\":";
+            vt::writeJson(output, summary);
+            output << ",\"speedup\":" << (summary.p50 > 0.0 ? baseline / summary.p50 : 0.0) << "}";
+            if (workers >= maxWorkers) {
+                break;
+            }
+        }
+        output << "\n]";
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    output << "}\n";
+    std::cerr << "wrote " << outputPath << '\n';
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#version 450
+
+// colour from the vertices instead of the object, fixed when the pipeline is built
+layout(constant_id = 0) const bool USE_VERTEX_COLOUR = false;
+
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec3 colour;
+
+// per-instance stream read out of VtIndirectCuller::Object, selected by each command's firstInstance
+layout(location = 2) in vec2 objectOffset;
+layout(location = 3) in vec3 objectColour;
+
+// offset moves every object at once, the colour is unused
+layout(push_constant) uniform Push {
+	vec2 offset;
+	vec3 colour;
+} push;
+
+layout(location = 0) out vec3 fragColour;
+
+void main() {
+	gl_Position	= vec4(position + objectOffset + push.offset, 0.0, 1.0);
+	fragColour = USE_VERTEX_COLOUR ? colour : objectColour;
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#version 450
+
+// colour from the vertices instead of the instance, fixed when the pipeline is built
+layout(constant_id = 0) const bool USE_VERTEX_COLOUR = false;
+
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec3 colour;
+
+// per-instance stream, see VtModel::Instance
+layout(location = 2) in vec2 instanceOffset;
+layout(location = 3) in vec3 instanceColour;
+
+layout(location = 0) out vec3 fragColour;
+
+void main() {
+	gl_Position	= vec4(position + instanceOffset, 0.0, 1.0);
+	fragColour = USE_VERTEX_COLOUR ? colour : instanceColour;
+}
\ No newline at end of file
@@ -1,5 +1,10 @@
 #version 450
 
+// colour from the vertices instead of the push constant, fixed when the pipeline is built
+layout(constant_id = 0) const bool USE_VERTEX_COLOUR = false;
+
+layout(location = 0) in vec3 fragColour;
+
 layout (location = 0) out vec4 outColour;
 
 layout(push_constant) uniform Push {
@@ -9,5 +14,5 @@ layout(push_constant) uniform Push {
 
 void main () {
 	//outColour = vec4(0.8f, 0.5f, 0.0f, 1.0f);	
-	outColour = vec4(push.colour, 1.0f);
+	outColour = vec4(USE_VERTEX_COLOUR ? fragColour : push.colour, 1.0f);
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 layout(location = 0) in vec2 position;
 layout(location = 1) in vec3 colour;
 
+layout(location = 0) out vec3 fragColour;
+
 layout(push_constant) uniform Push {
 	vec2 offset;
 	vec3 colour;
@@ -10,4 +12,5 @@ layout(push_constant) uniform Push {
 
 void main() {
 	gl_Position	= vec4(position + push.offset, 0.0, 1.0);
+	fragColour = colour;
 }
\ No newline at end of file
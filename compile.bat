@@ -1,3 +1,8 @@
 C:\VulkanSDK\1.2.189.2\Bin\glslc.exe Shaders\simple_shader.vert -o Shaders\simple_shader.vert.spv
 C:\VulkanSDK\1.2.189.2\Bin\glslc.exe Shaders\simple_shader.frag -o Shaders\simple_shader.frag.spv
+C:\VulkanSDK\1.2.189.2\Bin\glslc.exe Shaders\instanced_shader.vert -o Shaders\instanced_shader.vert.spv
+C:\VulkanSDK\1.2.189.2\Bin\glslc.exe Shaders\instanced_shader.frag -o Shaders\instanced_shader.frag.spv
+C:\VulkanSDK\1.2.189.2\Bin\glslc.exe Shaders\sierpinski.comp -o Shaders\sierpinski.comp.spv
+C:\VulkanSDK\1.2.189.2\Bin\glslc.exe Shaders\indirect_shader.vert -o Shaders\indirect_shader.vert.spv
+C:\VulkanSDK\1.2.189.2\Bin\glslc.exe Shaders\cull.comp -o Shaders\cull.comp.spv
 pause
\ No newline at end of file
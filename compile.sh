@@ -1,2 +1,7 @@
 C:/VulkanSDK/1.2.189.2/Bin/glslc.exe shaders/simple_shader.vert -o shaders/simple_shader.vert.spv
-C:/VulkanSDK/1.2.189.2/Bin/glslc.exe shaders/simple_shader.vert -o shaders/simple_shader.frag.spv
\ No newline at end of file
+C:/VulkanSDK/1.2.189.2/Bin/glslc.exe shaders/simple_shader.frag -o shaders/simple_shader.frag.spv
+C:/VulkanSDK/1.2.189.2/Bin/glslc.exe shaders/instanced_shader.vert -o shaders/instanced_shader.vert.spv
+C:/VulkanSDK/1.2.189.2/Bin/glslc.exe shaders/instanced_shader.frag -o shaders/instanced_shader.frag.spv
+C:/VulkanSDK/1.2.189.2/Bin/glslc.exe shaders/sierpinski.comp -o shaders/sierpinski.comp.spv
+C:/VulkanSDK/1.2.189.2/Bin/glslc.exe shaders/indirect_shader.vert -o shaders/indirect_shader.vert.spv
+C:/VulkanSDK/1.2.189.2/Bin/glslc.exe shaders/cull.comp -o shaders/cull.comp.spv
\ No newline at end of file
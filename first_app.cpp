@@ -7,7 +7,10 @@
 #include <stdexcept>
 #include <cassert>
 #include <array>
+#include <chrono>
+#include <cstddef>
 #include <iostream>
+#include <limits>
 
 namespace vt {
 
@@ -16,25 +19,106 @@ namespace vt {
         alignas(16) glm::vec3 colour;
     };
 
-    FirstApp::FirstApp() {
+    // Bytes the shaders' Push block spans; the struct's tail padding is not part of it.
+    static constexpr uint32_t SIMPLE_PUSH_CONSTANT_SIZE = offsetof(SimplePushConstantData, colour) + sizeof(glm::vec3);
+    // constant_id of USE_VERTEX_COLOUR in the simple fragment shader and the instanced and indirect vertex shaders.
+    static constexpr uint32_t VERTEX_COLOUR_CONSTANT_ID = 0;
+
+    // The stages of _pipeline reading SimplePushConstantData, after checking its shaders declare exactly that block.
+    static VkShaderStageFlags SimplePushConstantStages(const VtPipeline& _pipeline) {
+        const auto& ranges = _pipeline.getReflection().getPushConstantRanges();
+        if (ranges.size() != 1 || ranges[0].offset != 0 || ranges[0].size != SIMPLE_PUSH_CONSTANT_SIZE) {
+            throw std::runtime_error("Shader push constants do not match SimplePushConstantData!");
+        }
+        return ranges[0].stageFlags;
+    }
+
+    static VtModel::Vertex SierpinskiMidpoint(const VtModel::Vertex& _a, const VtModel::Vertex& _b) {
+        return VtModel::Vertex{ 0.5f * (_a.position + _b.position), 0.5f * (_a.colour + _b.colour) };
+    }
+
+    // Where object _index sits before the animation moves it.
+    static VtModel::Instance RestingObject(uint32_t _index) {
+        int row = _index % 4;
+        VtModel::Instance object{};
+        object.offset = { -0.5f + (_index / 4) * 0.001f, -0.4f + row * 0.25f };
+        object.colour = { 0.0f, 0.0f, 0.2f + 0.2f * row };
+        return object;
+    }
+
+    static glm::vec2 AnimationShift(int _animationFrame) {
+        return { _animationFrame * 0.02f, 0.0f };
+    }
+
+    FirstApp::FirstApp(const AppSettings& _settings)
+        : settings{ _settings },
+        jobSystem{ std::make_unique<VtJobSystem>(_settings.workerThreads) },
+        vtWindow{ _settings.headless ? nullptr : std::make_unique<VtWindow>(WIDTH, HEIGHT, "Vulkan Tutorial") },
+        vtDevice{ vtWindow.get() } {
+        if (settings.headless && settings.frameCount == 0) {
+            throw std::runtime_error("Headless mode needs a frame count, there is no window to close!");
+        }
+        if (settings.frame.framesInFlight == 0) {
+            throw std::runtime_error("At least one frame must be in flight!");
+        }
+
+        pipelineManager = std::make_unique<VtPipelineManager>(vtDevice);
+        instanceBuffer = std::make_unique<VtInstanceBuffer>(vtDevice, settings.frame.framesInFlight);
+        if (settings.enableProfiling) {
+            profiler = std::make_unique<VtProfiler>(vtDevice, settings.frame.framesInFlight);
+        }
+        if (settings.useParallelRecording) {
+            parallelRecorder = std::make_unique<VtParallelRecorder>(vtDevice, settings.frame.framesInFlight);
+        }
         loadModels();
-        CreatePipelineLayout();
+        if (settings.useGpuCulling) {
+            CreateIndirectCuller();
+        }
         RecreateSwapChain();
         CreateCommandBuffers();
+
+        ReportStartupPipelines();
+        vtDevice.layoutCache().reportReuse();
     }
 
     FirstApp::~FirstApp() {
-        vkDestroyPipelineLayout(vtDevice.device(), pipelineLayout, nullptr);
+        FreeCommandBuffers();
     }
 
     void FirstApp::run() {
-        
-        while (!vtWindow.shouldClose()) {
-            glfwPollEvents();
+        // Timings are only kept for fixed-length runs, an interactive session would grow them without bound.
+        bool collectTimings = settings.frameCount != 0;
+        if (collectTimings) {
+            timings.frameMilliseconds.reserve(settings.frameCount);
+            timings.recordMilliseconds.reserve(settings.frameCount);
+            timings.latencyMilliseconds.reserve(settings.frameCount);
+            timings.trianglesSubmitted.reserve(settings.frameCount);
+            pendingDrawCounts.assign(settings.frame.framesInFlight, std::numeric_limits<size_t>::max());
+        }
+
+        for (uint32_t frame = 0; settings.frameCount == 0 || frame < settings.frameCount; frame++) {
+            if (vtWindow != nullptr) {
+                if (vtWindow->shouldClose()) {
+                    break;
+                }
+                glfwPollEvents();
+            }
+            auto frameStart = std::chrono::steady_clock::now();
             DrawFrame();
+            if (collectTimings) {
+                timings.frameMilliseconds.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+            }
         }
 
         vkDeviceWaitIdle(vtDevice.device());
+        for (uint32_t frameIndex = 0; frameIndex < pendingDrawCounts.size(); frameIndex++) {
+            CollectDrawCount(frameIndex);
+        }
+
+        if (profiler != nullptr) {
+            profiler->collectAll();
+            profiler->writeChromeTrace(TRACE_FILEPATH);
+        }
     }
 
     void FirstApp::loadModels() {
@@ -44,70 +128,169 @@ namespace vt {
             {{-0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}}
         };
 
-        //std::vector<VtModel::Vertex> vertices{};
-        //SierpinskiTriangle(vertices, 7, { 0.0f, -0.9f }, { 0.9f, 0.9f }, { -0.9f, 0.9f });
+        auto loadStart = std::chrono::steady_clock::now();
+        VtModel::Vertex top{ { 0.0f, -0.9f }, { 1.0f, 0.0f, 0.0f } };
+        VtModel::Vertex right{ { 0.9f, 0.9f }, { 0.0f, 1.0f, 0.0f } };
+        VtModel::Vertex left{ { -0.9f, 0.9f }, { 0.0f, 0.0f, 1.0f } };
 
-        vtModel = std::make_unique<VtModel>(vtDevice, vertices);
-    }
+        bool generateOnGpu = settings.generateOnGpu && settings.sierpinskiDepth > 0;
+        if (generateOnGpu && !vtDevice.findPhysicalQueueFamilies().graphicsFamilyHasCompute) {
+            std::cout << "Graphics queue cannot run compute, generating the Sierpinski model on the CPU" << std::endl;
+            generateOnGpu = false;
+        }
 
-    void FirstApp::CreatePipelineLayout() {
+        if (generateOnGpu) {
+            VtSierpinskiGenerator generator{ vtDevice };
+            vtModel = generator.generate(settings.sierpinskiDepth, top, right, left);
+        }
+        else if (settings.sierpinskiDepth > 0) {
+            VtModel::Builder builder{};
+            SierpinskiTriangleParallel(builder, settings.sierpinskiDepth, top, right, left);
+            vtModel = std::make_unique<VtModel>(vtDevice, builder, VtModel::Usage::Static, settings.vertexFormat);
+        }
+        else {
+            vtModel = std::make_unique<VtModel>(vtDevice, vertices, VtModel::Usage::Static, settings.vertexFormat);
+        }
 
-        VkPushConstantRange pushConstantRange{};
-        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        // Submit every model's upload as one batch; draws pick them up once isReady() reports the copy retired.
+        vtDevice.uploadContext().flush();
+        modelLoadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+    }
 
-        pushConstantRange.offset = 0;
-        pushConstantRange.size = sizeof(SimplePushConstantData);
+    void FirstApp::CreateIndirectCuller() {
+        if (!vtDevice.findPhysicalQueueFamilies().graphicsFamilyHasCompute) {
+            std::cout << "Graphics queue cannot run compute, recording every draw on the CPU" << std::endl;
+            return;
+        }
+        if (!vtDevice.supportsMultiDrawIndirect()) {
+            std::cout << "Multi draw indirect is not supported, recording every draw on the CPU" << std::endl;
+            return;
+        }
+        if (!vtDevice.supportsDrawIndirectCount()) {
+            std::cout << "Draw indirect count is not supported, culled objects are drawn as empty commands" << std::endl;
+        }
 
-        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipelineLayoutInfo.setLayoutCount = 0;
-        pipelineLayoutInfo.pSetLayouts = nullptr;
-        pipelineLayoutInfo.pushConstantRangeCount = 1;
-        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
-        if (vkCreatePipelineLayout(vtDevice.device(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create pipeline layout!");
+        // The resting layout is uploaded once; every frame only pushes the animation shift.
+        VtModel::DrawRange range = vtModel->getDrawRange();
+        std::vector<VtIndirectCuller::Object> cullObjects(settings.objectCount);
+        for (uint32_t i = 0; i < settings.objectCount; i++) {
+            VtModel::Instance object = RestingObject(i);
+            cullObjects[i] = VtIndirectCuller::Object::fromRange(range, object.offset, object.colour);
         }
+        indirectCuller = std::make_unique<VtIndirectCuller>(vtDevice, settings.frame.framesInFlight, cullObjects, vtModel->isIndexed());
     }
 
     void FirstApp::CreatePipeline() {
-        assert(vtSwapChain != nullptr && "Cannot create pipeline before swap chain");
-        assert(pipelineLayout != nullptr && "Cannot create pipeline before pipeline layout");
+        assert(renderTarget != nullptr && "Cannot create pipeline before render target");
+        // Variants built for the previous render pass cannot be reused.
+        pipelineManager->clearVariants();
 
+        // The per-object pipeline is built right away and stands in while the others compile in the background.
         PipelineConfigInfo pipelineConfig{};
         VtPipeline::defaultPipelineConfigInfo(pipelineConfig);
+        pipelineConfig.vertexInput = vtModel->getVertexInput();
+        if (settings.useVertexColour) {
+            pipelineConfig.fragmentSpecialization.set(VERTEX_COLOUR_CONSTANT_ID, true);
+        }
 
-        pipelineConfig.renderPass = vtSwapChain->getRenderPass();
-        pipelineConfig.pipelineLayout = pipelineLayout;
-        vtPipeline = std::make_unique<VtPipeline>(
-            vtDevice,
+        pipelineConfig.renderPass = renderTarget->getRenderPass();
+        vtPipeline = pipelineManager->createFallback(
             "shaders/simple_shader.vert.spv",
             "shaders/simple_shader.frag.spv",
             pipelineConfig
             );
+        pushConstantStages = SimplePushConstantStages(vtPipeline.get());
+
+        if (settings.useInstancing) {
+            auto instancedConfig = std::make_unique<PipelineConfigInfo>();
+            VtPipeline::defaultPipelineConfigInfo(*instancedConfig);
+            instancedConfig->vertexInput = vtModel->getVertexInput<VtModel::Instance>();
+            if (settings.useVertexColour) {
+                instancedConfig->vertexSpecialization.set(VERTEX_COLOUR_CONSTANT_ID, true);
+            }
+
+            instancedConfig->renderPass = renderTarget->getRenderPass();
+            instancedPipeline = pipelineManager->requestVariant(
+                "shaders/instanced_shader.vert.spv",
+                "shaders/instanced_shader.frag.spv",
+                std::move(instancedConfig)
+                );
+        }
+
+        if (indirectCuller != nullptr) {
+            auto indirectConfig = std::make_unique<PipelineConfigInfo>();
+            VtPipeline::defaultPipelineConfigInfo(*indirectConfig);
+            indirectConfig->vertexInput = vtModel->getVertexInput<VtIndirectCuller::Object>();
+            if (settings.useVertexColour) {
+                indirectConfig->vertexSpecialization.set(VERTEX_COLOUR_CONSTANT_ID, true);
+            }
+
+            indirectConfig->renderPass = renderTarget->getRenderPass();
+            indirectPipeline = pipelineManager->requestVariant(
+                "shaders/indirect_shader.vert.spv",
+                "shaders/instanced_shader.frag.spv",
+                std::move(indirectConfig)
+                );
+            // Checked against the shaders once the pipeline is ready.
+            indirectPushConstantStages = 0;
+        }
     }
 
     void FirstApp::CreateCommandBuffers() {
-        commandBuffers.resize(vtSwapChain->imageCount());
+        // One pool per frame in flight, reset wholesale once that frame retires instead of buffer by buffer.
+        commandPools.resize(settings.frame.framesInFlight);
+        commandBuffers.resize(settings.frame.framesInFlight);
+
+        for (size_t i = 0; i < commandPools.size(); i++) {
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.queueFamilyIndex = vtDevice.findPhysicalQueueFamilies().graphicsFamily;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+            if (vkCreateCommandPool(vtDevice.device(), &poolInfo, nullptr, &commandPools[i]) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create frame command pool!");
+            }
 
-        VkCommandBufferAllocateInfo allocateInfo{};
-        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocateInfo.commandPool = vtDevice.getCommandPool();
-        allocateInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
+            VkCommandBufferAllocateInfo allocateInfo{};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocateInfo.commandPool = commandPools[i];
+            allocateInfo.commandBufferCount = 1;
 
-        if (vkAllocateCommandBuffers(vtDevice.device(), &allocateInfo, commandBuffers.data()) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to allocate command buffers!");
+            if (vkAllocateCommandBuffers(vtDevice.device(), &allocateInfo, &commandBuffers[i]) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to allocate command buffers!");
+            }
         }
     }
 
     void FirstApp::FreeCommandBuffers() {
-        vkFreeCommandBuffers(vtDevice.device(), vtDevice.getCommandPool(), static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+        // Destroying a pool frees every buffer allocated from it.
+        for (auto commandPool : commandPools) {
+            vkDestroyCommandPool(vtDevice.device(), commandPool, nullptr);
+        }
+        commandPools.clear();
         commandBuffers.clear();
     }
 
     void FirstApp::DrawFrame() {
+        VtCpuScope frameScope{ profiler.get(), "DrawFrame" };
+
+        vtDevice.uploadContext().collect();
+        ReportStartupPipelines();
+
         uint32_t imageIndex;
-        auto result = vtSwapChain->acquireNextImage(&imageIndex);
+        VkResult result;
+        {
+            VtCpuScope scope{ profiler.get(), "acquireNextImage" };
+            result = renderTarget->acquireNextImage(&imageIndex);
+        }
+        deletionQueue.collect(renderTarget->getRetiredFrameCount());
+        if (settings.frameCount != 0 && renderTarget->getLastFrameLatency() >= 0.0) {
+            timings.latencyMilliseconds.push_back(renderTarget->getLastFrameLatency());
+        }
+        if (settings.frameCount != 0) {
+            CollectDrawCount(renderTarget->getCurrentFrame());
+        }
 
         if (result == VK_ERROR_OUT_OF_DATE_KHR) {
             RecreateSwapChain();
@@ -118,10 +301,23 @@ namespace vt {
             throw std::runtime_error("Failed to acquire swap chain image!");
         }
 
+        auto recordStart = std::chrono::steady_clock::now();
         RecordCommandBuffer(imageIndex);
-        result = vtSwapChain->submitCommandBuffers(&commandBuffers[imageIndex], &imageIndex);
-        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || vtWindow.wasWindowResized()) {
-            vtWindow.resetWindowResizedFlag();
+        if (settings.frameCount != 0) {
+            timings.recordMilliseconds.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - recordStart).count());
+        }
+        {
+            VtCpuScope scope{ profiler.get(), "submitCommandBuffers" };
+            uint32_t frameIndex = renderTarget->getCurrentFrame();
+            if (profiler != nullptr) {
+                profiler->markSubmit(frameIndex);
+            }
+            result = renderTarget->submitCommandBuffers(&commandBuffers[frameIndex], &imageIndex);
+        }
+        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || (vtWindow != nullptr && vtWindow->wasWindowResized())) {
+            if (vtWindow != nullptr) {
+                vtWindow->resetWindowResizedFlag();
+            }
             RecreateSwapChain();
             return;
         }
@@ -130,47 +326,134 @@ namespace vt {
         }
     }
 
+    void FirstApp::ReportStartupPipelines() {
+        if (pipelineCreationReported) {
+            return;
+        }
+        // The instanced and indirect pipelines compile in the background, so wait for them to be counted.
+        if ((instancedPipeline.isValid() && !instancedPipeline.isReady()) ||
+            (indirectPipeline.isValid() && !indirectPipeline.isReady())) {
+            return;
+        }
+        vtDevice.pipelineCache().reportCreationTime();
+        pipelineCreationReported = true;
+    }
+
     void FirstApp::RecreateSwapChain() {
-        auto extent = vtWindow.getExtent();
+        // The offscreen ring never goes out of date, so headless runs only ever get here once.
+        if (vtWindow == nullptr) {
+            if (offscreenTarget == nullptr) {
+                offscreenTarget = std::make_unique<VtOffscreenTarget>(vtDevice, VkExtent2D{ WIDTH, HEIGHT }, settings.frame);
+                renderTarget = offscreenTarget.get();
+                CreatePipeline();
+            }
+            return;
+        }
+
+        auto extent = vtWindow->getExtent();
         while (extent.width == 0 || extent.height == 0) {
-            extent = vtWindow.getExtent();
+            extent = vtWindow->getExtent();
             glfwWaitEvents();
         }
-        vkDeviceWaitIdle(vtDevice.device());
 
+        // No device idle: the new swap chain takes over the frame slots, and everything frames already
+        // submitted may still use is destroyed once they retire. The old chain's destructor then also
+        // waits for its presents, see VtSwapChain::waitForPresents.
+        bool formatsChanged = true;
         if (vtSwapChain == nullptr) {
-            vtSwapChain = std::make_unique<VtSwapChain>(vtDevice, extent);
+            vtSwapChain = std::make_unique<VtSwapChain>(vtDevice, extent, settings.frame);
         }
         else {
-            vtSwapChain = std::make_unique<VtSwapChain>(vtDevice, extent, std::move(vtSwapChain));
-            if (vtSwapChain->imageCount() != commandBuffers.size()) {
-                FreeCommandBuffers();
-                CreateCommandBuffers();
+            std::shared_ptr<VtSwapChain> oldSwapChain = std::move(vtSwapChain);
+            vtSwapChain = std::make_unique<VtSwapChain>(vtDevice, extent, oldSwapChain, settings.frame);
+            formatsChanged = !oldSwapChain->compareSwapFormats(*vtSwapChain);
+            deletionQueue.push(vtSwapChain->getSubmittedFrameCount(), [oldSwapChain]() mutable { oldSwapChain.reset(); });
+        }
+        renderTarget = vtSwapChain.get();
+
+        // Viewport and scissor are dynamic, so a plain resize reuses the pipelines and their render pass.
+        if (formatsChanged || !vtPipeline.isValid()) {
+            if (vtPipeline.isValid()) {
+                deletionQueue.push(
+                    vtSwapChain->getSubmittedFrameCount(),
+                    [retired = std::vector<VtPipelineHandle>{ vtPipeline, instancedPipeline, indirectPipeline }]() mutable { retired.clear(); });
             }
+            CreatePipeline();
+        }
+    }
+
+    void FirstApp::UpdateObjects() {
+        animationFrame = (animationFrame + 1) % 100;
+
+        // The culler already holds every object on the GPU and is only handed the shift.
+        if (indirectCuller != nullptr && indirectPipeline.isReady()) {
+            return;
+        }
+
+        objects.resize(settings.objectCount);
+        for (uint32_t i = 0; i < settings.objectCount; i++) {
+            objects[i] = RestingObject(i);
+            objects[i].offset += AnimationShift(animationFrame);
         }
 
-        CreatePipeline();
+        if (settings.useCpuCulling) {
+            const VtModel::Bounds& bounds = vtModel->getBounds();
+            visibilityCuller.resize(settings.objectCount);
+            for (uint32_t i = 0; i < settings.objectCount; i++) {
+                visibilityCuller.setBounds(i, bounds.min + objects[i].offset, bounds.max + objects[i].offset);
+            }
+
+            // Visible indices come back in ascending order, so compacting in place never overwrites one still to be read.
+            uint32_t visibleCount = visibilityCuller.cull(VtVisibilityCuller::Rect{ { -1.0f, -1.0f }, { 1.0f, 1.0f } });
+            const uint32_t* visible = visibilityCuller.getVisible();
+            for (uint32_t i = 0; i < visibleCount; i++) {
+                objects[i] = objects[visible[i]];
+            }
+            objects.resize(visibleCount);
+        }
     }
 
     void FirstApp::RecordCommandBuffer(int imageIndex) {
+        VtCpuScope recordScope{ profiler.get(), "RecordCommandBuffer" };
 
-        static int frame = 0;
-        frame = (frame + 1) % 100;
+        UpdateObjects();
+
+        // The frame's fence has signalled in acquireNextImage, so everything recorded from its pool has retired.
+        uint32_t frameIndex = renderTarget->getCurrentFrame();
+        vkResetCommandPool(vtDevice.device(), commandPools[frameIndex], 0);
+        VkCommandBuffer commandBuffer = commandBuffers[frameIndex];
 
         VkCommandBufferBeginInfo beginInfo{};
         beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
-        if (vkBeginCommandBuffer(commandBuffers[imageIndex], &beginInfo) != VK_SUCCESS) {
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
             throw std::runtime_error("Failed to begin recording command buffer!");
         }
 
+        if (profiler != nullptr) {
+            profiler->beginFrame(frameIndex, commandBuffer);
+        }
+
+        // Culling is a compute pass, so it has to be recorded before the render pass begins.
+        bool drawIndirect = indirectCuller != nullptr && indirectPipeline.isReady() && vtModel->isReady() && indirectCuller->isReady();
+        if (drawIndirect) {
+            VtGpuScope cullZone{ profiler.get(), commandBuffer, "Cull" };
+            indirectCuller->cull(commandBuffer, frameIndex, AnimationShift(animationFrame));
+        }
+
+        uint32_t renderPassZone = 0;
+        if (profiler != nullptr) {
+            renderPassZone = profiler->beginGpuZone(commandBuffer, "RenderPass");
+        }
+
         VkRenderPassBeginInfo renderPassInfo{};
         renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderPassInfo.renderPass = vtSwapChain->getRenderPass();
-        renderPassInfo.framebuffer = vtSwapChain->getFrameBuffer(imageIndex);
+        renderPassInfo.renderPass = renderTarget->getRenderPass();
+        renderPassInfo.framebuffer = renderTarget->getFrameBuffer(imageIndex);
 
         renderPassInfo.renderArea.offset = { 0, 0 };
-        renderPassInfo.renderArea.extent = vtSwapChain->getSwapChainExtent();
+        renderPassInfo.renderArea.extent = renderTarget->getExtent();
 
         std::array<VkClearValue, 2> clearValues{};
         clearValues[0].color = { 0.01f, 0.01f, 0.01f, 1.0f };
@@ -178,60 +461,191 @@ namespace vt {
         renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
         renderPassInfo.pClearValues = clearValues.data();
 
-        vkCmdBeginRenderPass(commandBuffers[imageIndex], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        // Objects this frame draws; an indirect draw only learns its count on the GPU.
+        uint64_t drawnObjects = 0;
+
+        // The instanced path is a single draw, so only the per-object path is worth spreading over workers.
+        bool recordInParallel = settings.useParallelRecording && !settings.useInstancing && indirectCuller == nullptr && vtModel->isReady();
+        vkCmdBeginRenderPass(
+            commandBuffer,
+            &renderPassInfo,
+            recordInParallel ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+
+        if (recordInParallel) {
+            VkCommandBufferInheritanceInfo inheritanceInfo{};
+            inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+            inheritanceInfo.renderPass = renderTarget->getRenderPass();
+            inheritanceInfo.subpass = 0;
+            inheritanceInfo.framebuffer = renderTarget->getFrameBuffer(imageIndex);
+
+            // Dynamic state is not inherited, so every secondary buffer sets its own viewport and scissor.
+            const auto& secondaryBuffers = parallelRecorder->record(
+                frameIndex,
+                inheritanceInfo,
+                static_cast<uint32_t>(objects.size()),
+                [this](VkCommandBuffer _commandBuffer, uint32_t _begin, uint32_t _end) {
+                    SetViewportAndScissor(_commandBuffer);
+                    vtPipeline->bind(_commandBuffer);
+                    vtModel->bind(_commandBuffer);
+                    RecordObjects(_commandBuffer, _begin, _end);
+                });
+
+            if (!secondaryBuffers.empty()) {
+                vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(secondaryBuffers.size()), secondaryBuffers.data());
+            }
+            drawnObjects = objects.size();
+        }
+        else {
+            // Timestamps are not allowed in a subpass whose contents are secondary buffers, so draws are only timed inline.
+            VtGpuScope drawZone{ profiler.get(), commandBuffer, "Draws" };
+            SetViewportAndScissor(commandBuffer);
+
+            if (drawIndirect) {
+                SimplePushConstantData push{};
+                push.offset = AnimationShift(animationFrame);
+
+                if (indirectPushConstantStages == 0) {
+                    indirectPushConstantStages = SimplePushConstantStages(indirectPipeline.get());
+                }
+
+                indirectPipeline->bind(commandBuffer);
+                vtModel->bind(commandBuffer);
+                vkCmdPushConstants(
+                    commandBuffer,
+                    indirectPipeline->getLayout(),
+                    indirectPushConstantStages,
+                    0,
+                    SIMPLE_PUSH_CONSTANT_SIZE,
+                    &push
+                );
+                indirectCuller->draw(commandBuffer, frameIndex);
+            }
+            // Until their pipelines are compiled, the indirect and instanced paths fall back to per-object draws.
+            else if (vtModel->isReady() && (indirectCuller == nullptr || !indirectPipeline.isReady())) {
+                drawnObjects = objects.size();
+                if (instancedPipeline.isReady()) {
+                    instanceBuffer->write(frameIndex, objects);
+
+                    instancedPipeline->bind(commandBuffer);
+                    vtModel->bind(commandBuffer);
+                    instanceBuffer->bind(commandBuffer, frameIndex);
+                    vtModel->drawInstanced(commandBuffer, static_cast<uint32_t>(objects.size()));
+                }
+                else {
+                    vtPipeline->bind(commandBuffer);
+                    vtModel->bind(commandBuffer);
+                    RecordObjects(commandBuffer, 0, static_cast<uint32_t>(objects.size()));
+                }
+            }
+        }
+
+        vkCmdEndRenderPass(commandBuffer);
+        if (profiler != nullptr) {
+            profiler->endGpuZone(commandBuffer, renderPassZone);
+        }
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to record command buffer!");
+        }
+
+        if (settings.frameCount != 0) {
+            if (drawIndirect) {
+                pendingDrawCounts[frameIndex] = timings.trianglesSubmitted.size();
+            }
+            timings.trianglesSubmitted.push_back(drawnObjects * vtModel->getTriangleCount());
+        }
+    }
+
+    void FirstApp::CollectDrawCount(uint32_t _frameIndex) {
+        size_t& pending = pendingDrawCounts[_frameIndex];
+        if (pending == std::numeric_limits<size_t>::max()) {
+            return;
+        }
+
+        timings.trianglesSubmitted[pending] = static_cast<uint64_t>(indirectCuller->getDrawCount(_frameIndex)) * vtModel->getTriangleCount();
+        pending = std::numeric_limits<size_t>::max();
+    }
 
+    void FirstApp::SetViewportAndScissor(VkCommandBuffer _commandBuffer) {
         VkViewport viewport{};
         viewport.x = 0.0f;
         viewport.y = 0.0f;
-        viewport.width = static_cast<float>(vtSwapChain->getSwapChainExtent().width);
-        viewport.height = static_cast<float>(vtSwapChain->getSwapChainExtent().height);
+        viewport.width = static_cast<float>(renderTarget->getExtent().width);
+        viewport.height = static_cast<float>(renderTarget->getExtent().height);
         viewport.minDepth = 0.0f;
         viewport.maxDepth = 1.0f;
-        VkRect2D scissor{ {0, 0}, vtSwapChain->getSwapChainExtent() };
-        vkCmdSetViewport(commandBuffers[imageIndex], 0, 1, &viewport);
-        vkCmdSetScissor(commandBuffers[imageIndex], 0, 1, &scissor);
-
-        vtPipeline->bind(commandBuffers[imageIndex]);
-        vtModel->bind(commandBuffers[imageIndex]);
+        VkRect2D scissor{ {0, 0}, renderTarget->getExtent() };
+        vkCmdSetViewport(_commandBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(_commandBuffer, 0, 1, &scissor);
+    }
 
-        for (int i = 0; i < 4; i++) {
+    void FirstApp::RecordObjects(VkCommandBuffer _commandBuffer, uint32_t _begin, uint32_t _end) {
+        for (uint32_t i = _begin; i < _end; i++) {
             SimplePushConstantData push{};
-
-            push.offset = { -0.5f + frame * 0.02f, -0.4f + i * 0.25f };
-            push.colour = { 0.0f, 0.0f, 0.2f + 0.2f * i };
+            push.offset = objects[i].offset;
+            push.colour = objects[i].colour;
 
             vkCmdPushConstants(
-                commandBuffers[imageIndex], 
-                pipelineLayout, 
-                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 
-                0, 
-                sizeof(SimplePushConstantData), 
+                _commandBuffer,
+                vtPipeline->getLayout(),
+                pushConstantStages,
+                0,
+                SIMPLE_PUSH_CONSTANT_SIZE,
                 &push
             );
 
-            vtModel->draw(commandBuffers[imageIndex]);
-        }
-
-        vkCmdEndRenderPass(commandBuffers[imageIndex]);
-        if (vkEndCommandBuffer(commandBuffers[imageIndex]) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to record command buffer!");
+            vtModel->draw(_commandBuffer);
         }
     }
 
-    void FirstApp::SierpinskiTriangle(std::vector<VtModel::Vertex>& _vertices, int _depth, glm::vec2 _top, glm::vec2 _right, glm::vec2 _left) {
-        glm::vec3 colour{ 1.0f, 0.3f, 0.0f };
+    void FirstApp::SierpinskiTriangle(VtModel::Builder& _builder, int _depth, VtModel::Vertex _top, VtModel::Vertex _right, VtModel::Vertex _left) {
         if (_depth <= 0) {
-            _vertices.push_back({ _top , {1.0f, 0.0f, 0.0f} });
-            _vertices.push_back({ _right, {0.0f, 1.0f, 0.0f} });
-            _vertices.push_back({ _left , {0.0f, 0.0f, 1.0f} });
+            _builder.addVertex(_top);
+            _builder.addVertex(_right);
+            _builder.addVertex(_left);
         }
         else {
-            auto topRight = 0.5f * (_top + _right);
-            auto leftTop = 0.5f * (_left + _top);
-            auto rightLeft = 0.5f * (_right + _left);
-            SierpinskiTriangle(_vertices, _depth - 1, _top, topRight, leftTop);
-            SierpinskiTriangle(_vertices, _depth - 1, _right, rightLeft, topRight);
-            SierpinskiTriangle(_vertices, _depth - 1, _left, leftTop, rightLeft);
+            // Midpoints are computed once and handed to both neighbouring sub-triangles, so shared
+            // corners are bit-identical and the builder welds them into a single vertex.
+            auto topRight = SierpinskiMidpoint(_top, _right);
+            auto leftTop = SierpinskiMidpoint(_left, _top);
+            auto rightLeft = SierpinskiMidpoint(_right, _left);
+            SierpinskiTriangle(_builder, _depth - 1, _top, topRight, leftTop);
+            SierpinskiTriangle(_builder, _depth - 1, _right, rightLeft, topRight);
+            SierpinskiTriangle(_builder, _depth - 1, _left, leftTop, rightLeft);
+        }
+    }
+
+    void FirstApp::SierpinskiTriangleParallel(VtModel::Builder& _builder, int _depth, VtModel::Vertex _top, VtModel::Vertex _right, VtModel::Vertex _left) {
+        // Expand the top levels breadth first until there are a few sub-triangles per thread to steal.
+        // Each level keeps the depth first order of the sequential recursion.
+        std::vector<std::array<VtModel::Vertex, 3>> parts{ { _top, _right, _left } };
+        int splitDepth = 0;
+        while (splitDepth < _depth && parts.size() < 4 * (jobSystem->workerCount() + 1)) {
+            std::vector<std::array<VtModel::Vertex, 3>> children;
+            children.reserve(parts.size() * 3);
+            for (const auto& part : parts) {
+                auto topRight = SierpinskiMidpoint(part[0], part[1]);
+                auto leftTop = SierpinskiMidpoint(part[2], part[0]);
+                auto rightLeft = SierpinskiMidpoint(part[1], part[2]);
+                children.push_back({ part[0], topRight, leftTop });
+                children.push_back({ part[1], rightLeft, topRight });
+                children.push_back({ part[2], leftTop, rightLeft });
+            }
+            parts.swap(children);
+            splitDepth++;
+        }
+
+        std::vector<VtModel::Builder> builders(parts.size());
+        jobSystem->parallelFor(0, static_cast<uint32_t>(parts.size()), 1, [&](uint32_t _begin, uint32_t _end) {
+            for (uint32_t i = _begin; i < _end; i++) {
+                SierpinskiTriangle(builders[i], _depth - splitDepth, parts[i][0], parts[i][1], parts[i][2]);
+            }
+        });
+
+        // Appending in order welds across part boundaries and gives exactly the sequential result.
+        for (const auto& builder : builders) {
+            _builder.append(builder);
         }
     }
 }
\ No newline at end of file
@@ -1,23 +1,78 @@
 #pragma once
 
 #include "vt_window.h"
+#include "vt_deletion_queue.h"
 #include "vt_pipeline.h"
+#include "vt_pipeline_manager.h"
 #include "vt_device.h"
 #include "vt_swap_chain.h"
+#include "vt_offscreen_target.h"
 #include "vt_model.h"
+#include "vt_instance_buffer.h"
+#include "vt_indirect_culler.h"
+#include "vt_visibility_culler.h"
+#include "vt_parallel_recorder.h"
+#include "vt_profiler.h"
+#include "vt_sierpinski_generator.h"
+#include "vt_job_system.h"
 
 #include <memory>
 #include <vector>
 
 namespace vt {
 
+    struct AppSettings {
+        // Render into an offscreen image ring with no window, surface or GLFW.
+        bool headless = false;
+        // Frames to draw before run() returns; 0 runs until the window is closed. Required when headless.
+        uint32_t frameCount = 0;
+
+        // Recursion depth of the Sierpinski model; 0 draws the single coloured triangle.
+        int sierpinskiDepth = 0;
+        // Generate the Sierpinski model with a compute shader straight into device-local memory.
+        bool generateOnGpu = false;
+        // Vertex storage of CPU built models; the GPU generator always writes float vertices.
+        VtVertexFormat vertexFormat = VtVertexFormat::Float;
+        // Shade with the model's vertex colours instead of the per-object colour, through a specialization constant.
+        bool useVertexColour = false;
+        // Job system workers next to the main thread; 0 keeps CPU work such as mesh building on the main thread.
+        uint32_t workerThreads = VtJobSystem::defaultWorkerCount();
+        uint32_t objectCount = 4;
+
+        // One draw for every object through the per-instance stream instead of a push-constant draw each.
+        bool useInstancing = false;
+        // Drops objects whose bounds lie outside the view on the CPU, before any draw or instance is recorded.
+        bool useCpuCulling = false;
+        // Culls the objects in a compute pass that writes indirect draw commands, then draws them all with one
+        // indirect draw. Takes precedence over instancing and parallel recording.
+        bool useGpuCulling = false;
+        // Splits the per-object draws across worker threads, each recording a secondary command buffer.
+        bool useParallelRecording = false;
+        // CPU scopes and GPU timestamps for every frame, written out as a Chrome trace when the app closes.
+        bool enableProfiling = false;
+
+        // Present mode, frames in flight and image count of the render target.
+        VtFrameSettings frame{};
+    };
+
+    // Wall-clock cost of each frame run() drew, in milliseconds.
+    struct FrameTimings {
+        std::vector<double> frameMilliseconds;
+        std::vector<double> recordMilliseconds;
+        // Submit to fence retirement of each frame, see VtRenderTarget::getLastFrameLatency.
+        std::vector<double> latencyMilliseconds;
+        // Triangles each frame actually drew, after CPU or GPU culling. GPU culled frames are filled in
+        // from the culler's draw count once they retire.
+        std::vector<uint64_t> trianglesSubmitted;
+    };
+
     class FirstApp {
 
     public:
         static constexpr int WIDTH = 800;
         static constexpr int HEIGHT = 600;
 
-        FirstApp();
+        FirstApp(const AppSettings& _settings = {});
         ~FirstApp();
 
         FirstApp(const FirstApp&) = delete;
@@ -25,24 +80,69 @@ namespace vt {
 
         void run();
 
+        const FrameTimings& getTimings() const { return timings; }
+        // CPU wall time spent building the model, including the GPU generation wait but not the async upload.
+        double getModelLoadMilliseconds() const { return modelLoadMilliseconds; }
+        VtDevice& getDevice() { return vtDevice; }
+
     private:
         void loadModels();
-        void CreatePipelineLayout();
+        void CreateIndirectCuller();
         void CreatePipeline();
         void CreateCommandBuffers();
         void FreeCommandBuffers();
         void DrawFrame();
         void RecreateSwapChain();
+        // Prints the pipeline cache's creation time once every startup pipeline has compiled.
+        void ReportStartupPipelines();
         void RecordCommandBuffer(int imageIndex);
+        // Fills in the triangles of the frame slot's last indirect draw; its fence must have signalled.
+        void CollectDrawCount(uint32_t _frameIndex);
+        void SetViewportAndScissor(VkCommandBuffer _commandBuffer);
+        void RecordObjects(VkCommandBuffer _commandBuffer, uint32_t _begin, uint32_t _end);
+        void UpdateObjects();
 
-        void SierpinskiTriangle(std::vector<VtModel::Vertex>& _vertices, int _depth, glm::vec2 _top, glm::vec2 _left, glm::vec2 _right);
+        void SierpinskiTriangle(VtModel::Builder& _builder, int _depth, VtModel::Vertex _top, VtModel::Vertex _right, VtModel::Vertex _left);
+        void SierpinskiTriangleParallel(VtModel::Builder& _builder, int _depth, VtModel::Vertex _top, VtModel::Vertex _right, VtModel::Vertex _left);
 
-        VtWindow vtWindow{ WIDTH, HEIGHT, "Vulkan Tutorial" };
-        VtDevice vtDevice{ vtWindow };
+        AppSettings settings;
+        std::unique_ptr<VtJobSystem> jobSystem;
+        std::unique_ptr<VtWindow> vtWindow;
+        VtDevice vtDevice;
+        // Swap chains and pipelines replaced on resize, destroyed once the frames using them have retired.
+        VtDeletionQueue deletionQueue;
         std::unique_ptr<VtSwapChain> vtSwapChain;
-        std::unique_ptr<VtPipeline> vtPipeline;
-        VkPipelineLayout pipelineLayout;
+        std::unique_ptr<VtOffscreenTarget> offscreenTarget;
+        VtRenderTarget* renderTarget = nullptr;
+        std::unique_ptr<VtPipelineManager> pipelineManager;
+        // The manager's fallback, also the pipeline of the per-object path.
+        VtPipelineHandle vtPipeline;
+        VtPipelineHandle instancedPipeline;
+        VtPipelineHandle indirectPipeline;
+        // Stages reading SimplePushConstantData in the simple and the indirect pipeline, as their shaders declare it.
+        VkShaderStageFlags pushConstantStages = 0;
+        VkShaderStageFlags indirectPushConstantStages = 0;
+        // Startup pipelines only; resizes rebuild them from the in-memory cache and would skew the number.
+        bool pipelineCreationReported = false;
+        std::vector<VkCommandPool> commandPools;
         std::vector<VkCommandBuffer> commandBuffers;
         std::unique_ptr<VtModel> vtModel;
+        double modelLoadMilliseconds = 0.0;
+
+        int animationFrame = 0;
+        // Objects to draw this frame, only the visible ones when CPU culling is on.
+        std::vector<VtModel::Instance> objects;
+        VtVisibilityCuller visibilityCuller;
+        std::unique_ptr<VtInstanceBuffer> instanceBuffer;
+        std::unique_ptr<VtIndirectCuller> indirectCuller;
+
+        std::unique_ptr<VtParallelRecorder> parallelRecorder;
+
+        static constexpr const char* TRACE_FILEPATH = "frame_trace.json";
+        std::unique_ptr<VtProfiler> profiler;
+
+        FrameTimings timings;
+        // Per frame slot, the trianglesSubmitted entry still waiting on the culler's draw count, or SIZE_MAX.
+        std::vector<size_t> pendingDrawCounts;
     };
 }
\ No newline at end of file
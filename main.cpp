@@ -1,14 +1,78 @@
 #include "first_app.h"
 
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
 
-int main() {
+int main(int argc, char** argv) {
 
-    vt::FirstApp app{};
+    vt::AppSettings settings{};
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            settings.headless = true;
+        }
+        else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            settings.frameCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--depth") == 0 && i + 1 < argc) {
+            settings.sierpinskiDepth = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--vertex-format") == 0 && i + 1 < argc && vt::parseVertexFormat(argv[i + 1], settings.vertexFormat)) {
+            i++;
+        }
+        else if (std::strcmp(argv[i], "--vertex-colour") == 0) {
+            settings.useVertexColour = true;
+        }
+        else if (std::strcmp(argv[i], "--gpu-geometry") == 0) {
+            settings.generateOnGpu = true;
+        }
+        else if (std::strcmp(argv[i], "--objects") == 0 && i + 1 < argc) {
+            settings.objectCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--instanced") == 0) {
+            settings.useInstancing = true;
+        }
+        else if (std::strcmp(argv[i], "--cpu-culling") == 0) {
+            settings.useCpuCulling = true;
+        }
+        else if (std::strcmp(argv[i], "--gpu-culling") == 0) {
+            settings.useGpuCulling = true;
+        }
+        else if (std::strcmp(argv[i], "--parallel") == 0) {
+            settings.useParallelRecording = true;
+        }
+        else if (std::strcmp(argv[i], "--profile") == 0) {
+            settings.enableProfiling = true;
+        }
+        else if (std::strcmp(argv[i], "--present-mode") == 0 && i + 1 < argc && vt::parsePresentMode(argv[i + 1], settings.frame.presentMode)) {
+            i++;
+        }
+        else if (std::strcmp(argv[i], "--frames-in-flight") == 0 && i + 1 < argc) {
+            settings.frame.framesInFlight = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--image-count") == 0 && i + 1 < argc) {
+            settings.frame.imageCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--timeline") == 0) {
+            settings.frame.useTimelineSemaphores = true;
+        }
+        else if (std::strcmp(argv[i], "--transient-depth") == 0) {
+            settings.frame.useTransientDepth = true;
+        }
+        else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            settings.workerThreads = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else {
+            std::cerr << "usage: " << argv[0]
+                << " [--headless] [--frames <count>] [--depth <n>] [--vertex-format float|snorm16|half] [--vertex-colour] [--gpu-geometry] [--objects <n>] [--instanced] [--cpu-culling] [--gpu-culling] [--parallel] [--profile]"
+                << " [--present-mode fifo|fifo-relaxed|mailbox|immediate] [--frames-in-flight <n>] [--image-count <n>] [--timeline] [--transient-depth] [--workers <n>]" << '\n';
+            return EXIT_FAILURE;
+        }
+    }
 
     try {
+        vt::FirstApp app{ settings };
         app.run();
     }
     catch (const std::exception& e) {
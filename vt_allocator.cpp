@@ -0,0 +1,261 @@
+#include "vt_allocator.h"
+
+//std
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <stdexcept>
+
+namespace vt {
+
+    static VkDeviceSize alignUp(VkDeviceSize _value, VkDeviceSize _alignment) {
+        return (_value + _alignment - 1) / _alignment * _alignment;
+    }
+
+    // Two resources conflict under bufferImageGranularity if the last byte of the first
+    // and the first byte of the second land on the same granularity "page".
+    static bool onSamePage(VkDeviceSize _endOfFirst, VkDeviceSize _startOfSecond, VkDeviceSize _pageSize) {
+        return (_endOfFirst & ~(_pageSize - 1)) == (_startOfSecond & ~(_pageSize - 1));
+    }
+
+    VtAllocator::VtAllocator(VkDevice _device, VkPhysicalDevice _physicalDevice) : device{ _device } {
+        vkGetPhysicalDeviceMemoryProperties(_physicalDevice, &memoryProperties);
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(_physicalDevice, &properties);
+        bufferImageGranularity = std::max<VkDeviceSize>(1, properties.limits.bufferImageGranularity);
+
+        blocksPerType.resize(memoryProperties.memoryTypeCount);
+    }
+
+    VtAllocator::~VtAllocator() {
+        for (auto& blocks : blocksPerType) {
+            for (auto& block : blocks) {
+                assert(block->allocationCount == 0 && "Allocator destroyed with live allocations");
+                destroyBlock(*block);
+            }
+        }
+    }
+
+    VtAllocation VtAllocator::allocate(const VkMemoryRequirements& _requirements, uint32_t _memoryTypeIndex, ResourceKind _kind) {
+        assert(_memoryTypeIndex < blocksPerType.size() && "Memory type index out of range");
+
+        std::lock_guard<std::mutex> lock{ mutex };
+
+        auto& blocks = blocksPerType[_memoryTypeIndex];
+        VkDeviceSize blockSize = preferredBlockSize(_memoryTypeIndex);
+        VkDeviceSize alignment = std::max<VkDeviceSize>(1, _requirements.alignment);
+
+        Block* target = nullptr;
+        VkDeviceSize offset = 0;
+
+        // Anything bigger than half a block gets its own allocation rather than wasting the remainder.
+        if (_requirements.size > blockSize / 2) {
+            target = &createBlock(_memoryTypeIndex, _requirements.size, true);
+            allocateFromBlock(*target, _requirements.size, alignment, _kind, offset);
+        }
+        else {
+            for (auto& block : blocks) {
+                if (!block->dedicated && allocateFromBlock(*block, _requirements.size, alignment, _kind, offset)) {
+                    target = block.get();
+                    break;
+                }
+            }
+
+            if (target == nullptr) {
+                target = &createBlock(_memoryTypeIndex, blockSize, false);
+                if (!allocateFromBlock(*target, _requirements.size, alignment, _kind, offset)) {
+                    throw std::runtime_error("failed to sub-allocate from a fresh memory block!");
+                }
+            }
+        }
+
+        target->allocationCount++;
+
+        VtAllocation allocation{};
+        allocation.memory = target->memory;
+        allocation.offset = offset;
+        allocation.size = _requirements.size;
+        allocation.mapped = target->mapped != nullptr ? static_cast<char*>(target->mapped) + offset : nullptr;
+        allocation.memoryTypeIndex = _memoryTypeIndex;
+        allocation.blockId = target->id;
+        return allocation;
+    }
+
+    void VtAllocator::free(VtAllocation& _allocation) {
+        if (_allocation.memory == VK_NULL_HANDLE) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock{ mutex };
+
+        auto& blocks = blocksPerType[_allocation.memoryTypeIndex];
+        auto blockIt = std::find_if(blocks.begin(), blocks.end(), [&](const auto& _block) { return _block->id == _allocation.blockId; });
+        assert(blockIt != blocks.end() && "Freeing an allocation that does not belong to this allocator");
+
+        Block& block = **blockIt;
+        auto it = block.ranges.find(_allocation.offset);
+        assert(it != block.ranges.end() && !it->second.free && "Double free of allocation");
+
+        it->second.free = true;
+
+        auto next = std::next(it);
+        if (next != block.ranges.end() && next->second.free) {
+            it->second.size += next->second.size;
+            block.ranges.erase(next);
+        }
+
+        if (it != block.ranges.begin()) {
+            auto prev = std::prev(it);
+            if (prev->second.free) {
+                prev->second.size += it->second.size;
+                block.ranges.erase(it);
+            }
+        }
+
+        block.allocationCount--;
+
+        // Dedicated blocks go straight back to the driver; pooled blocks are kept until a second one is empty,
+        // so a load/unload cycle does not thrash vkAllocateMemory.
+        if (block.allocationCount == 0) {
+            size_t emptyBlocks = std::count_if(blocks.begin(), blocks.end(), [](const auto& _block) { return _block->allocationCount == 0 && !_block->dedicated; });
+            if (block.dedicated || emptyBlocks > 1) {
+                destroyBlock(block);
+                blocks.erase(blockIt);
+            }
+        }
+
+        _allocation = VtAllocation{};
+    }
+
+    VtAllocator::Stats VtAllocator::getStats() {
+        std::lock_guard<std::mutex> lock{ mutex };
+
+        Stats stats{};
+        for (uint32_t i = 0; i < blocksPerType.size(); i++) {
+            accumulateStats(i, stats);
+        }
+        stats.peakReservedBytes = peakReservedBytes;
+        return stats;
+    }
+
+    VtAllocator::Stats VtAllocator::getStats(uint32_t _memoryTypeIndex) {
+        std::lock_guard<std::mutex> lock{ mutex };
+
+        Stats stats{};
+        accumulateStats(_memoryTypeIndex, stats);
+        return stats;
+    }
+
+    VtAllocator::Block& VtAllocator::createBlock(uint32_t _memoryTypeIndex, VkDeviceSize _size, bool _dedicated) {
+        auto block = std::make_unique<Block>();
+        block->size = _size;
+        block->id = nextBlockId++;
+        block->dedicated = _dedicated;
+
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = _size;
+        allocInfo.memoryTypeIndex = _memoryTypeIndex;
+
+        if (vkAllocateMemory(device, &allocInfo, nullptr, &block->memory) != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate memory block!");
+        }
+
+        if (memoryProperties.memoryTypes[_memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+            if (vkMapMemory(device, block->memory, 0, VK_WHOLE_SIZE, 0, &block->mapped) != VK_SUCCESS) {
+                throw std::runtime_error("failed to map memory block!");
+            }
+        }
+
+        block->ranges.emplace(0, Range{ _size, true, ResourceKind::Linear });
+
+        reservedBytes += _size;
+        peakReservedBytes = std::max(peakReservedBytes, reservedBytes);
+
+        auto& blocks = blocksPerType[_memoryTypeIndex];
+        blocks.push_back(std::move(block));
+        return *blocks.back();
+    }
+
+    void VtAllocator::destroyBlock(Block& _block) {
+        if (_block.mapped != nullptr) {
+            vkUnmapMemory(device, _block.memory);
+            _block.mapped = nullptr;
+        }
+        vkFreeMemory(device, _block.memory, nullptr);
+        _block.memory = VK_NULL_HANDLE;
+        reservedBytes -= _block.size;
+    }
+
+    bool VtAllocator::allocateFromBlock(Block& _block, VkDeviceSize _size, VkDeviceSize _alignment, ResourceKind _kind, VkDeviceSize& _offset) {
+        for (auto it = _block.ranges.begin(); it != _block.ranges.end(); ++it) {
+            if (!it->second.free || it->second.size < _size) {
+                continue;
+            }
+
+            VkDeviceSize start = it->first;
+            VkDeviceSize end = start + it->second.size;
+            VkDeviceSize offset = alignUp(start, _alignment);
+
+            // Free ranges are always merged, so the neighbours of a free range are in use.
+            if (bufferImageGranularity > 1 && it != _block.ranges.begin()) {
+                auto prev = std::prev(it);
+                if (prev->second.kind != _kind && onSamePage(prev->first + prev->second.size - 1, offset, bufferImageGranularity)) {
+                    offset = alignUp(offset, bufferImageGranularity);
+                }
+            }
+
+            if (offset + _size > end) {
+                continue;
+            }
+
+            auto next = std::next(it);
+            if (bufferImageGranularity > 1 && next != _block.ranges.end() &&
+                next->second.kind != _kind && onSamePage(offset + _size - 1, next->first, bufferImageGranularity)) {
+                continue;
+            }
+
+            _block.ranges.erase(it);
+            if (offset > start) {
+                _block.ranges.emplace(start, Range{ offset - start, true, ResourceKind::Linear });
+            }
+            _block.ranges.emplace(offset, Range{ _size, false, _kind });
+            if (offset + _size < end) {
+                _block.ranges.emplace(offset + _size, Range{ end - (offset + _size), true, ResourceKind::Linear });
+            }
+
+            _offset = offset;
+            return true;
+        }
+
+        return false;
+    }
+
+    void VtAllocator::accumulateStats(uint32_t _memoryTypeIndex, Stats& _stats) {
+        for (const auto& block : blocksPerType[_memoryTypeIndex]) {
+            _stats.blockCount++;
+            _stats.allocationCount += block->allocationCount;
+            _stats.reservedBytes += block->size;
+
+            for (const auto& [offset, range] : block->ranges) {
+                if (range.free) {
+                    _stats.freeRangeCount++;
+                    _stats.largestFreeRange = std::max(_stats.largestFreeRange, range.size);
+                }
+                else {
+                    _stats.usedBytes += range.size;
+                }
+            }
+        }
+    }
+
+    VkDeviceSize VtAllocator::preferredBlockSize(uint32_t _memoryTypeIndex) {
+        // Small heaps (integrated GPUs, the 256MB BAR window) get proportionally smaller blocks.
+        VkDeviceSize heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[_memoryTypeIndex].heapIndex].size;
+        if (heapSize <= 1024ull * 1024 * 1024) {
+            return std::min(DEFAULT_BLOCK_SIZE, alignUp(heapSize / 8, 32));
+        }
+        return DEFAULT_BLOCK_SIZE;
+    }
+}
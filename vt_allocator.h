@@ -0,0 +1,96 @@
+#pragma once
+
+//vulkan
+#include <vulkan/vulkan.h>
+
+//std
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vt {
+
+    // A sub-range of one of the allocator's blocks. Resources bind to (memory, offset).
+    // Host visible blocks stay persistently mapped, so mapped already points at offset.
+    struct VtAllocation {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        void* mapped = nullptr;
+        uint32_t memoryTypeIndex = 0;
+        uint32_t blockId = 0;
+    };
+
+    class VtAllocator {
+    public:
+        // Buffers and linear images may not share a bufferImageGranularity page with optimal images.
+        enum class ResourceKind { Linear, Optimal };
+
+        struct Stats {
+            uint32_t blockCount = 0;
+            uint32_t allocationCount = 0;
+            VkDeviceSize reservedBytes = 0;
+            VkDeviceSize usedBytes = 0;
+            uint32_t freeRangeCount = 0;
+            VkDeviceSize largestFreeRange = 0;
+            // High-water mark of reservedBytes over the allocator's lifetime; only filled in by getStats().
+            VkDeviceSize peakReservedBytes = 0;
+
+            // 0 when all free space is one contiguous range, approaching 1 as it splinters.
+            float fragmentation() const {
+                VkDeviceSize freeBytes = reservedBytes - usedBytes;
+                return freeBytes == 0 ? 0.0f : 1.0f - static_cast<float>(largestFreeRange) / static_cast<float>(freeBytes);
+            }
+        };
+
+        static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull * 1024 * 1024;
+
+        VtAllocator(VkDevice _device, VkPhysicalDevice _physicalDevice);
+        ~VtAllocator();
+
+        VtAllocator(const VtAllocator&) = delete;
+        VtAllocator& operator=(const VtAllocator&) = delete;
+
+        VtAllocation allocate(const VkMemoryRequirements& _requirements, uint32_t _memoryTypeIndex, ResourceKind _kind);
+        void free(VtAllocation& _allocation);
+
+        Stats getStats();
+        Stats getStats(uint32_t _memoryTypeIndex);
+
+    private:
+        struct Range {
+            VkDeviceSize size;
+            bool free;
+            ResourceKind kind;
+        };
+
+        struct Block {
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            VkDeviceSize size = 0;
+            void* mapped = nullptr;
+            uint32_t id = 0;
+            uint32_t allocationCount = 0;
+            bool dedicated = false;
+
+            // Keyed by offset; covers the whole block, adjacent free ranges are always merged.
+            std::map<VkDeviceSize, Range> ranges;
+        };
+
+        Block& createBlock(uint32_t _memoryTypeIndex, VkDeviceSize _size, bool _dedicated);
+        void destroyBlock(Block& _block);
+        bool allocateFromBlock(Block& _block, VkDeviceSize _size, VkDeviceSize _alignment, ResourceKind _kind, VkDeviceSize& _offset);
+        void accumulateStats(uint32_t _memoryTypeIndex, Stats& _stats);
+        VkDeviceSize preferredBlockSize(uint32_t _memoryTypeIndex);
+
+        VkDevice device;
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        VkDeviceSize bufferImageGranularity;
+        uint32_t nextBlockId = 1;
+        VkDeviceSize reservedBytes = 0;
+        VkDeviceSize peakReservedBytes = 0;
+
+        std::vector<std::vector<std::unique_ptr<Block>>> blocksPerType;
+        std::mutex mutex;
+    };
+}
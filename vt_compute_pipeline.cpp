@@ -0,0 +1,81 @@
+#include "vt_compute_pipeline.h"
+
+#include "vt_pipeline.h"
+
+//std
+#include <cassert>
+#include <chrono>
+#include <stdexcept>
+
+namespace vt {
+
+    VtComputePipeline::VtComputePipeline(VtDevice& _device, const std::string& _compFilepath, VkPipelineLayout _pipelineLayout)
+        : vtDevice{ _device } {
+        assert(_pipelineLayout != VK_NULL_HANDLE && "Cannot create compute pipeline:: no pipelineLayout provided");
+
+        auto compCode = VtPipeline::readFile(_compFilepath);
+
+        VkShaderModuleCreateInfo moduleInfo{};
+        moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        moduleInfo.codeSize = compCode.size();
+        moduleInfo.pCode = reinterpret_cast<const uint32_t*>(compCode.data());
+
+        if (vkCreateShaderModule(vtDevice.device(), &moduleInfo, nullptr, &compShaderModule) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create shader module");
+        }
+
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfo.stage.module = compShaderModule;
+        pipelineInfo.stage.pName = "main";
+        pipelineInfo.layout = _pipelineLayout;
+        pipelineInfo.basePipelineIndex = -1;
+        pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+        auto start = std::chrono::steady_clock::now();
+        if (vkCreateComputePipelines(vtDevice.device(), vtDevice.pipelineCache().handle(), 1, &pipelineInfo, nullptr, &computePipeline) != VK_SUCCESS) {
+            vkDestroyShaderModule(vtDevice.device(), compShaderModule, nullptr);
+            throw std::runtime_error("Failed to create compute pipeline");
+        }
+        vtDevice.pipelineCache().recordCreation(std::chrono::steady_clock::now() - start);
+    }
+
+    VtComputePipeline::~VtComputePipeline() {
+        vkDestroyShaderModule(vtDevice.device(), compShaderModule, nullptr);
+        vkDestroyPipeline(vtDevice.device(), computePipeline, nullptr);
+    }
+
+    void VtComputePipeline::bind(VkCommandBuffer _commandBuffer) {
+        vkCmdBindPipeline(_commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline);
+    }
+
+    void VtComputePipeline::dispatch(VkCommandBuffer _commandBuffer, uint32_t _groupCountX, uint32_t _groupCountY, uint32_t _groupCountZ) {
+        const auto& limits = vtDevice.properties.limits;
+        assert(_groupCountX <= limits.maxComputeWorkGroupCount[0] &&
+            _groupCountY <= limits.maxComputeWorkGroupCount[1] &&
+            _groupCountZ <= limits.maxComputeWorkGroupCount[2] && "Dispatch exceeds the device's workgroup count limit");
+        vkCmdDispatch(_commandBuffer, _groupCountX, _groupCountY, _groupCountZ);
+    }
+
+    void VtComputePipeline::bufferBarrier(
+        VkCommandBuffer _commandBuffer,
+        VkBuffer _buffer,
+        VkPipelineStageFlags _srcStage,
+        VkAccessFlags _srcAccess,
+        VkPipelineStageFlags _dstStage,
+        VkAccessFlags _dstAccess) {
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = _srcAccess;
+        barrier.dstAccessMask = _dstAccess;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = _buffer;
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+
+        vkCmdPipelineBarrier(_commandBuffer, _srcStage, _dstStage, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+    }
+}
\ No newline at end of file
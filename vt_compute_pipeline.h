@@ -0,0 +1,40 @@
+#pragma once
+
+#include "vt_device.h"
+
+//std
+#include <string>
+
+namespace vt {
+
+    // A single compute shader stage. The layout is owned by the caller, as with VtPipeline, so it can
+    // carry whatever descriptor sets and push constants the shader declares.
+    class VtComputePipeline {
+    public:
+        VtComputePipeline(VtDevice& _device, const std::string& _compFilepath, VkPipelineLayout _pipelineLayout);
+        ~VtComputePipeline();
+
+        VtComputePipeline(const VtComputePipeline&) = delete;
+        VtComputePipeline& operator=(const VtComputePipeline&) = delete;
+
+        void bind(VkCommandBuffer _commandBuffer);
+        void dispatch(VkCommandBuffer _commandBuffer, uint32_t _groupCountX, uint32_t _groupCountY = 1, uint32_t _groupCountZ = 1);
+
+        // Workgroups of _groupSize needed to cover _invocations.
+        static uint32_t groupCount(uint32_t _invocations, uint32_t _groupSize) { return (_invocations + _groupSize - 1) / _groupSize; }
+
+        // Makes _srcAccess writes from _srcStage to the whole of _buffer visible to _dstAccess in _dstStage.
+        static void bufferBarrier(
+            VkCommandBuffer _commandBuffer,
+            VkBuffer _buffer,
+            VkPipelineStageFlags _srcStage,
+            VkAccessFlags _srcAccess,
+            VkPipelineStageFlags _dstStage,
+            VkAccessFlags _dstAccess);
+
+    private:
+        VtDevice& vtDevice;
+        VkPipeline computePipeline;
+        VkShaderModule compShaderModule;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include "vt_deletion_queue.h"
+
+//std
+#include <cassert>
+#include <utility>
+
+namespace vt {
+
+    VtDeletionQueue::~VtDeletionQueue() {
+        flush();
+    }
+
+    void VtDeletionQueue::push(uint64_t _frameCount, std::function<void()> _deleter) {
+        assert((entries.empty() || entries.back().frameCount <= _frameCount) && "Deletions must be queued in frame order");
+        entries.push_back({ _frameCount, std::move(_deleter) });
+    }
+
+    void VtDeletionQueue::collect(uint64_t _retiredFrameCount) {
+        while (!entries.empty() && entries.front().frameCount <= _retiredFrameCount) {
+            // Popped first so a deleter that queues more work cannot invalidate the entry it runs from.
+            std::function<void()> deleter = std::move(entries.front().deleter);
+            entries.pop_front();
+            deleter();
+        }
+    }
+
+    void VtDeletionQueue::flush() {
+        while (!entries.empty()) {
+            std::function<void()> deleter = std::move(entries.front().deleter);
+            entries.pop_front();
+            deleter();
+        }
+    }
+}
\ No newline at end of file
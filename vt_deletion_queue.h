@@ -0,0 +1,42 @@
+#pragma once
+
+//std
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+namespace vt {
+
+    // Defers destroying GPU objects until the frames that may still use them have retired, so
+    // replacing them (a resized swap chain, a rebuilt pipeline) never has to idle the device.
+    // Frames are counted as VtRenderTarget counts them; single threaded, like frame submission.
+    class VtDeletionQueue {
+    public:
+        VtDeletionQueue() = default;
+        // Runs whatever is still queued; the device must be idle by then.
+        ~VtDeletionQueue();
+
+        VtDeletionQueue(const VtDeletionQueue&) = delete;
+        VtDeletionQueue& operator=(const VtDeletionQueue&) = delete;
+
+        // Runs _deleter once the first _frameCount submitted frames have retired. Pass the render
+        // target's getSubmittedFrameCount() at the moment the objects stop being used.
+        void push(uint64_t _frameCount, std::function<void()> _deleter);
+
+        // Runs, oldest first, every deleter whose frames are within _retiredFrameCount. Cheap, call once per frame.
+        void collect(uint64_t _retiredFrameCount);
+        // Runs every deleter regardless of frames, for when the device is idle.
+        void flush();
+
+        size_t size() const { return entries.size(); }
+
+    private:
+        struct Entry {
+            uint64_t frameCount;
+            std::function<void()> deleter;
+        };
+
+        // Pushed with non-decreasing frame counts, so the ready ones are always at the front.
+        std::deque<Entry> entries;
+    };
+}
\ No newline at end of file
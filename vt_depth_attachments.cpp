@@ -0,0 +1,65 @@
+#include "vt_depth_attachments.h"
+
+//std
+#include <stdexcept>
+
+namespace vt {
+
+    VtDepthAttachments::VtDepthAttachments(VtDevice& _device, VkExtent2D _extent, VkFormat _format, uint32_t _count, bool _transient)
+        : vtDevice{ _device }, format{ _format } {
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = _extent.width;
+        imageInfo.extent.height = _extent.height;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = format;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.flags = 0;
+
+        // Desktop GPUs have no lazily allocated memory; the transient usage is then only a hint.
+        VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        if (_transient) {
+            imageInfo.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+            lazilyAllocated = vtDevice.supportsLazilyAllocatedMemory();
+            if (lazilyAllocated) {
+                properties |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+            }
+        }
+
+        images.resize(_count);
+        memorys.resize(_count);
+        views.resize(_count);
+        for (uint32_t i = 0; i < _count; i++) {
+            vtDevice.createImageWithInfo(imageInfo, properties, images[i], memorys[i]);
+
+            VkImageViewCreateInfo viewInfo{};
+            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewInfo.image = images[i];
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format = format;
+            viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+            viewInfo.subresourceRange.baseMipLevel = 0;
+            viewInfo.subresourceRange.levelCount = 1;
+            viewInfo.subresourceRange.baseArrayLayer = 0;
+            viewInfo.subresourceRange.layerCount = 1;
+
+            if (vkCreateImageView(vtDevice.device(), &viewInfo, nullptr, &views[i]) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create texture image view!");
+            }
+        }
+    }
+
+    VtDepthAttachments::~VtDepthAttachments() {
+        for (size_t i = 0; i < images.size(); i++) {
+            vkDestroyImageView(vtDevice.device(), views[i], nullptr);
+            vtDevice.destroyImage(images[i], memorys[i]);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "vt_device.h"
+
+//vulkan
+#include <vulkan/vulkan.h>
+
+//std
+#include <vector>
+
+namespace vt {
+
+    // The depth images a render target draws with, one per frame in flight rather than one per colour
+    // image. Depth is cleared on load and never stored, and a frame slot is only reused once its fence
+    // or timeline value has retired, so frames in flight never share an image.
+    class VtDepthAttachments {
+    public:
+        // _transient creates the images as transient attachments in lazily allocated memory where the
+        // device has it, so tile-based GPUs can keep depth on chip and never back it with memory.
+        VtDepthAttachments(VtDevice& _device, VkExtent2D _extent, VkFormat _format, uint32_t _count, bool _transient);
+        ~VtDepthAttachments();
+
+        VtDepthAttachments(const VtDepthAttachments&) = delete;
+        VtDepthAttachments& operator=(const VtDepthAttachments&) = delete;
+
+        VkImageView getView(uint32_t _frame) const { return views[_frame]; }
+        uint32_t count() const { return static_cast<uint32_t>(views.size()); }
+        VkFormat getFormat() const { return format; }
+        // True when the images actually live in lazily allocated memory.
+        bool isLazilyAllocated() const { return lazilyAllocated; }
+
+    private:
+        VtDevice& vtDevice;
+        VkFormat format;
+        bool lazilyAllocated = false;
+
+        std::vector<VkImage> images;
+        std::vector<VtAllocation> memorys;
+        std::vector<VkImageView> views;
+    };
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "vt_device.h"
 
 // std headers
+#include <cassert>
 #include <cstring>
 #include <iostream>
 #include <set>
@@ -47,17 +48,44 @@ namespace vt {
         }
     }
 
+    static bool InstanceExtensionAvailable(const char* _name) {
+        uint32_t extensionCount = 0;
+        vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
+        std::vector<VkExtensionProperties> extensions(extensionCount);
+        vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, extensions.data());
+        for (const auto& extension : extensions) {
+            if (std::strcmp(extension.extensionName, _name) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     // class member functions
-    VtDevice::VtDevice(VtWindow& window) : window{ window } {
+    VtDevice::VtDevice(VtWindow* window) : window{ window } {
+        if (isHeadless()) {
+            deviceExtensions.clear();
+        }
+
         createInstance();
         setupDebugMessenger();
         createSurface();
         pickPhysicalDevice();
         createLogicalDevice();
         createCommandPool();
+        createAllocator();
+        createUploadContext();
+        createPipelineCache();
+        createLayoutCache();
+        createTimelines();
     }
 
     VtDevice::~VtDevice() {
+        graphicsTimeline_.reset();
+        layoutCache_.reset();
+        pipelineCache_.reset();
+        uploadContext_.reset();
+        allocator_.reset();
         vkDestroyCommandPool(device_, commandPool, nullptr);
         vkDestroyDevice(device_, nullptr);
 
@@ -65,7 +93,9 @@ namespace vt {
             DestroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
         }
 
-        vkDestroySurfaceKHR(instance, surface_, nullptr);
+        if (!isHeadless()) {
+            vkDestroySurfaceKHR(instance, surface_, nullptr);
+        }
         vkDestroyInstance(instance, nullptr);
     }
 
@@ -80,13 +110,27 @@ namespace vt {
         appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
         appInfo.pEngineName = "No Engine";
         appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-        appInfo.apiVersion = VK_API_VERSION_1_0;
+        // Ask for 1.2 when the loader knows about it, for timeline semaphores; the device may still be older.
+        uint32_t loaderVersion = VK_API_VERSION_1_0;
+        vkEnumerateInstanceVersion(&loaderVersion);
+        instanceApiVersion = loaderVersion >= VK_API_VERSION_1_2 ? VK_API_VERSION_1_2 : VK_API_VERSION_1_0;
+        appInfo.apiVersion = instanceApiVersion;
 
         VkInstanceCreateInfo createInfo = {};
         createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
         createInfo.pApplicationInfo = &appInfo;
 
         auto extensions = getRequiredExtensions();
+#ifdef VK_EXT_swapchain_maintenance1
+        // Optional: VK_EXT_swapchain_maintenance1, for present fences, builds on these two.
+        if (!isHeadless() && instanceApiVersion >= VK_API_VERSION_1_1 &&
+            InstanceExtensionAvailable(VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME) &&
+            InstanceExtensionAvailable(VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME)) {
+            extensions.push_back(VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME);
+            extensions.push_back(VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME);
+            surfaceMaintenanceEnabled = true;
+        }
+#endif
         createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
         createInfo.ppEnabledExtensionNames = extensions.data();
 
@@ -137,9 +181,13 @@ namespace vt {
 
     void VtDevice::createLogicalDevice() {
         QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
+        queueFamilyIndices_ = indices;
 
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
         std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily, indices.presentFamily };
+        if (indices.transferFamilyHasValue) {
+            uniqueQueueFamilies.insert(indices.transferFamily);
+        }
 
         float queuePriority = 1.0f;
         for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -151,8 +199,15 @@ namespace vt {
             queueCreateInfos.push_back(queueCreateInfo);
         }
 
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+
         VkPhysicalDeviceFeatures deviceFeatures = {};
         deviceFeatures.samplerAnisotropy = VK_TRUE;
+        // GPU driven draws write one command per object, each selecting its object through firstInstance.
+        multiDrawIndirectEnabled = supportedFeatures.multiDrawIndirect && supportedFeatures.drawIndirectFirstInstance;
+        deviceFeatures.multiDrawIndirect = multiDrawIndirectEnabled ? VK_TRUE : VK_FALSE;
+        deviceFeatures.drawIndirectFirstInstance = multiDrawIndirectEnabled ? VK_TRUE : VK_FALSE;
 
         VkDeviceCreateInfo createInfo = {};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -161,8 +216,33 @@ namespace vt {
         createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
         createInfo.pEnabledFeatures = &deviceFeatures;
-        createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-        createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+
+        VkPhysicalDeviceVulkan12Features supportedVulkan12Features{};
+        supportedVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        VkPhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        if (checkVulkan12Features(physicalDevice, supportedVulkan12Features)) {
+            timelineSemaphoresEnabled = supportedVulkan12Features.timelineSemaphore == VK_TRUE;
+            drawIndirectCountEnabled = supportedVulkan12Features.drawIndirectCount == VK_TRUE;
+            vulkan12Features.timelineSemaphore = supportedVulkan12Features.timelineSemaphore;
+            vulkan12Features.drawIndirectCount = supportedVulkan12Features.drawIndirectCount;
+            createInfo.pNext = &vulkan12Features;
+        }
+
+        std::vector<const char*> enabledExtensions = deviceExtensions;
+#ifdef VK_EXT_swapchain_maintenance1
+        VkPhysicalDeviceSwapchainMaintenance1FeaturesEXT swapchainMaintenance1Features{};
+        swapchainMaintenance1Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SWAPCHAIN_MAINTENANCE_1_FEATURES_EXT;
+        if (surfaceMaintenanceEnabled && checkSwapchainMaintenance1(physicalDevice)) {
+            swapchainMaintenance1Features.swapchainMaintenance1 = VK_TRUE;
+            swapchainMaintenance1Features.pNext = const_cast<void*>(createInfo.pNext);
+            createInfo.pNext = &swapchainMaintenance1Features;
+            enabledExtensions.push_back(VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME);
+            presentFencesEnabled = true;
+        }
+#endif
+        createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+        createInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
         // might not really be necessary anymore because device specific validation layers
         // have been deprecated
@@ -180,6 +260,13 @@ namespace vt {
 
         vkGetDeviceQueue(device_, indices.graphicsFamily, 0, &graphicsQueue_);
         vkGetDeviceQueue(device_, indices.presentFamily, 0, &presentQueue_);
+
+        if (indices.transferFamilyHasValue) {
+            vkGetDeviceQueue(device_, indices.transferFamily, 0, &transferQueue_);
+        }
+        else {
+            transferQueue_ = graphicsQueue_;
+        }
     }
 
     void VtDevice::createCommandPool() {
@@ -196,15 +283,53 @@ namespace vt {
         }
     }
 
-    void VtDevice::createSurface() { window.createWindowSurface(instance, &surface_); }
+    void VtDevice::createAllocator() { allocator_ = std::make_unique<VtAllocator>(device_, physicalDevice); }
+
+    void VtDevice::createUploadContext() {
+        QueueFamilyIndices indices = findPhysicalQueueFamilies();
+        uint32_t family = indices.transferFamilyHasValue ? indices.transferFamily : indices.graphicsFamily;
+        uploadContext_ = std::make_unique<VtUploadContext>(device_, transferQueue_, queueMutex(transferQueue_), family);
+    }
+
+    std::mutex& VtDevice::queueMutex(VkQueue _queue) {
+        // Checked in this order so a queue aliasing the graphics queue always maps to the graphics mutex.
+        if (_queue == graphicsQueue_) {
+            return graphicsQueueMutex_;
+        }
+        if (_queue == presentQueue_) {
+            return presentQueueMutex_;
+        }
+        assert(_queue == transferQueue_ && "Queue does not belong to this device");
+        return transferQueueMutex_;
+    }
+
+    void VtDevice::createPipelineCache() {
+        pipelineCache_ = std::make_unique<VtPipelineCache>(device_, properties, "pipeline_cache.bin");
+    }
+
+    void VtDevice::createLayoutCache() {
+        layoutCache_ = std::make_unique<VtLayoutCache>(device_);
+    }
+
+    void VtDevice::createTimelines() {
+        if (timelineSemaphoresEnabled) {
+            graphicsTimeline_ = std::make_unique<VtTimeline>(device_);
+        }
+    }
+
+    void VtDevice::createSurface() {
+        if (!isHeadless()) {
+            window->createWindowSurface(instance, &surface_);
+        }
+    }
 
     bool VtDevice::isDeviceSuitable(VkPhysicalDevice device) {
         QueueFamilyIndices indices = findQueueFamilies(device);
 
         bool extensionsSupported = checkDeviceExtensionSupport(device);
 
-        bool swapChainAdequate = false;
-        if (extensionsSupported) {
+        bool swapChainAdequate = isHeadless();
+        if (extensionsSupported && !isHeadless()) {
             SwapChainSupportDetails swapChainSupport = querySwapChainSupport(device);
             swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
         }
@@ -264,11 +389,15 @@ namespace vt {
     }
 
     std::vector<const char*> VtDevice::getRequiredExtensions() {
-        uint32_t glfwExtensionCount = 0;
-        const char** glfwExtensions;
-        glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        std::vector<const char*> extensions;
 
-        std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        // GLFW is never initialised without a window, and without a surface no WSI extension is needed.
+        if (!isHeadless()) {
+            uint32_t glfwExtensionCount = 0;
+            const char** glfwExtensions;
+            glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        }
 
         if (enableValidationLayers) {
             extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -320,6 +449,48 @@ namespace vt {
         return requiredExtensions.empty();
     }
 
+    bool VtDevice::checkVulkan12Features(VkPhysicalDevice device, VkPhysicalDeviceVulkan12Features& vulkan12Features) {
+        VkPhysicalDeviceProperties deviceProperties;
+        vkGetPhysicalDeviceProperties(device, &deviceProperties);
+        if (instanceApiVersion < VK_API_VERSION_1_2 || deviceProperties.apiVersion < VK_API_VERSION_1_2) {
+            return false;
+        }
+
+        VkPhysicalDeviceFeatures2 features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &vulkan12Features;
+        vkGetPhysicalDeviceFeatures2(device, &features);
+
+        return true;
+    }
+
+    bool VtDevice::checkSwapchainMaintenance1(VkPhysicalDevice device) {
+#ifdef VK_EXT_swapchain_maintenance1
+        uint32_t extensionCount;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+        std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+        bool available = false;
+        for (const auto& extension : availableExtensions) {
+            available = available || std::strcmp(extension.extensionName, VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME) == 0;
+        }
+        if (!available) {
+            return false;
+        }
+
+        VkPhysicalDeviceSwapchainMaintenance1FeaturesEXT swapchainMaintenance1Features{};
+        swapchainMaintenance1Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SWAPCHAIN_MAINTENANCE_1_FEATURES_EXT;
+        VkPhysicalDeviceFeatures2 features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &swapchainMaintenance1Features;
+        vkGetPhysicalDeviceFeatures2(device, &features);
+        return swapchainMaintenance1Features.swapchainMaintenance1 == VK_TRUE;
+#else
+        return false;
+#endif
+    }
+
     QueueFamilyIndices VtDevice::findQueueFamilies(VkPhysicalDevice device) {
         QueueFamilyIndices indices;
 
@@ -334,9 +505,17 @@ namespace vt {
             if (queueFamily.queueCount > 0 && queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
                 indices.graphicsFamily = i;
                 indices.graphicsFamilyHasValue = true;
+                indices.graphicsTimestampValidBits = queueFamily.timestampValidBits;
+                indices.graphicsFamilyHasCompute = (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) != 0;
             }
+            // Headless devices never present, so the graphics family stands in for the present family.
             VkBool32 presentSupport = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface_, &presentSupport);
+            if (isHeadless()) {
+                presentSupport = indices.graphicsFamilyHasValue && indices.graphicsFamily == static_cast<uint32_t>(i);
+            }
+            else {
+                vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface_, &presentSupport);
+            }
             if (queueFamily.queueCount > 0 && presentSupport) {
                 indices.presentFamily = i;
                 indices.presentFamilyHasValue = true;
@@ -348,6 +527,20 @@ namespace vt {
             i++;
         }
 
+        // Prefer a transfer-only family (DMA engine), then any non-graphics family that can transfer.
+        for (uint32_t pass = 0; pass < 2 && !indices.transferFamilyHasValue; pass++) {
+            VkQueueFlags excluded = pass == 0 ? (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT) : VK_QUEUE_GRAPHICS_BIT;
+            for (uint32_t family = 0; family < queueFamilyCount; family++) {
+                const auto& queueFamily = queueFamilies[family];
+                if (queueFamily.queueCount > 0 && (queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+                    !(queueFamily.queueFlags & excluded)) {
+                    indices.transferFamily = family;
+                    indices.transferFamilyHasValue = true;
+                    break;
+                }
+            }
+        }
+
         return indices;
     }
 
@@ -407,18 +600,43 @@ namespace vt {
         throw std::runtime_error("failed to find suitable memory type!");
     }
 
+    bool VtDevice::supportsLazilyAllocatedMemory() {
+        VkMemoryPropertyFlags lazilyAllocated = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+        VkPhysicalDeviceMemoryProperties memProperties;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+        for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+            if ((memProperties.memoryTypes[i].propertyFlags & lazilyAllocated) == lazilyAllocated) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     void VtDevice::createBuffer(
         VkDeviceSize size,
         VkBufferUsageFlags usage,
         VkMemoryPropertyFlags properties,
         VkBuffer& buffer,
-        VkDeviceMemory& bufferMemory) {
+        VtAllocation& bufferMemory,
+        bool sharedWithTransfer) {
         VkBufferCreateInfo bufferInfo{};
         bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         bufferInfo.size = size;
         bufferInfo.usage = usage;
         bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+        // Upload destinations are written on the transfer queue and read on the graphics queue;
+        // concurrent sharing avoids a queue family ownership transfer per upload. Only those opt in,
+        // since concurrent sharing can cost access speed on some implementations.
+        QueueFamilyIndices indices = findPhysicalQueueFamilies();
+        uint32_t queueFamilyIndices[] = { indices.graphicsFamily, indices.transferFamily };
+        if (sharedWithTransfer && indices.transferFamilyHasValue) {
+            assert((usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT) && "Transfer shared buffers must be copy destinations");
+            bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            bufferInfo.queueFamilyIndexCount = 2;
+            bufferInfo.pQueueFamilyIndices = queueFamilyIndices;
+        }
+
         if (vkCreateBuffer(device_, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
             throw std::runtime_error("failed to create vertex buffer!");
         }
@@ -426,16 +644,19 @@ namespace vt {
         VkMemoryRequirements memRequirements;
         vkGetBufferMemoryRequirements(device_, buffer, &memRequirements);
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
+        bufferMemory = allocator_->allocate(
+            memRequirements,
+            findMemoryType(memRequirements.memoryTypeBits, properties),
+            VtAllocator::ResourceKind::Linear);
 
-        if (vkAllocateMemory(device_, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
-            throw std::runtime_error("failed to allocate vertex buffer memory!");
+        if (vkBindBufferMemory(device_, buffer, bufferMemory.memory, bufferMemory.offset) != VK_SUCCESS) {
+            throw std::runtime_error("failed to bind buffer memory!");
         }
+    }
 
-        vkBindBufferMemory(device_, buffer, bufferMemory, 0);
+    void VtDevice::destroyBuffer(VkBuffer buffer, VtAllocation& bufferMemory) {
+        vkDestroyBuffer(device_, buffer, nullptr);
+        allocator_->free(bufferMemory);
     }
 
     VkCommandBuffer VtDevice::beginSingleTimeCommands() {
@@ -464,75 +685,95 @@ namespace vt {
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &commandBuffer;
 
-        vkQueueSubmit(graphicsQueue_, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(graphicsQueue_);
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
 
-        vkFreeCommandBuffers(device_, commandPool, 1, &commandBuffer);
-    }
+        VkFence fence;
+        vkCreateFence(device_, &fenceInfo, nullptr, &fence);
 
-    void VtDevice::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
-        VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+        {
+            std::lock_guard<std::mutex> lock{ queueMutex(graphicsQueue_) };
+            vkQueueSubmit(graphicsQueue_, 1, &submitInfo, fence);
+        }
+        vkWaitForFences(device_, 1, &fence, VK_TRUE, UINT64_MAX);
 
-        VkBufferCopy copyRegion{};
-        copyRegion.srcOffset = 0;  // Optional
-        copyRegion.dstOffset = 0;  // Optional
-        copyRegion.size = size;
-        vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+        vkDestroyFence(device_, fence, nullptr);
+        vkFreeCommandBuffers(device_, commandPool, 1, &commandBuffer);
+    }
 
-        endSingleTimeCommands(commandBuffer);
+    VtUploadTicket VtDevice::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
+        return uploadContext_->record([&](VkCommandBuffer commandBuffer) {
+            VkBufferCopy copyRegion{};
+            copyRegion.srcOffset = 0;  // Optional
+            copyRegion.dstOffset = 0;  // Optional
+            copyRegion.size = size;
+            vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+        });
     }
 
-    void VtDevice::copyBufferToImage(
+    VtUploadTicket VtDevice::copyBufferToImage(
         VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, uint32_t layerCount) {
-        VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
-        VkBufferImageCopy region{};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
-
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = layerCount;
-
-        region.imageOffset = { 0, 0, 0 };
-        region.imageExtent = { width, height, 1 };
-
-        vkCmdCopyBufferToImage(
-            commandBuffer,
-            buffer,
-            image,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            1,
-            &region);
-        endSingleTimeCommands(commandBuffer);
+        return uploadContext_->record([&](VkCommandBuffer commandBuffer) {
+            VkBufferImageCopy region{};
+            region.bufferOffset = 0;
+            region.bufferRowLength = 0;
+            region.bufferImageHeight = 0;
+
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = 0;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = layerCount;
+
+            region.imageOffset = { 0, 0, 0 };
+            region.imageExtent = { width, height, 1 };
+
+            vkCmdCopyBufferToImage(
+                commandBuffer,
+                buffer,
+                image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                1,
+                &region);
+        });
     }
 
     void VtDevice::createImageWithInfo(
         const VkImageCreateInfo& imageInfo,
         VkMemoryPropertyFlags properties,
         VkImage& image,
-        VkDeviceMemory& imageMemory) {
-        if (vkCreateImage(device_, &imageInfo, nullptr, &image) != VK_SUCCESS) {
+        VtAllocation& imageMemory,
+        bool sharedWithTransfer) {
+        VkImageCreateInfo createInfo = imageInfo;
+
+        QueueFamilyIndices indices = findPhysicalQueueFamilies();
+        uint32_t queueFamilyIndices[] = { indices.graphicsFamily, indices.transferFamily };
+        if (sharedWithTransfer && indices.transferFamilyHasValue) {
+            assert((imageInfo.usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT) && "Transfer shared images must be copy destinations");
+            createInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            createInfo.queueFamilyIndexCount = 2;
+            createInfo.pQueueFamilyIndices = queueFamilyIndices;
+        }
+
+        if (vkCreateImage(device_, &createInfo, nullptr, &image) != VK_SUCCESS) {
             throw std::runtime_error("failed to create image!");
         }
 
         VkMemoryRequirements memRequirements;
         vkGetImageMemoryRequirements(device_, image, &memRequirements);
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-
-        if (vkAllocateMemory(device_, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) {
-            throw std::runtime_error("failed to allocate image memory!");
-        }
+        imageMemory = allocator_->allocate(
+            memRequirements,
+            findMemoryType(memRequirements.memoryTypeBits, properties),
+            imageInfo.tiling == VK_IMAGE_TILING_LINEAR ? VtAllocator::ResourceKind::Linear : VtAllocator::ResourceKind::Optimal);
 
-        if (vkBindImageMemory(device_, image, imageMemory, 0) != VK_SUCCESS) {
+        if (vkBindImageMemory(device_, image, imageMemory.memory, imageMemory.offset) != VK_SUCCESS) {
             throw std::runtime_error("failed to bind image memory!");
         }
     }
 
+    void VtDevice::destroyImage(VkImage image, VtAllocation& imageMemory) {
+        vkDestroyImage(device_, image, nullptr);
+        allocator_->free(imageMemory);
+    }
+
 }  // namespace vt
\ No newline at end of file
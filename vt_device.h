@@ -1,8 +1,15 @@
 #pragma once
 
 #include "vt_window.h"
+#include "vt_allocator.h"
+#include "vt_upload_context.h"
+#include "vt_pipeline_cache.h"
+#include "vt_layout_cache.h"
+#include "vt_timeline.h"
 
 // std lib headers
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -17,8 +24,12 @@ namespace vt {
     struct QueueFamilyIndices {
         uint32_t graphicsFamily;
         uint32_t presentFamily;
+        uint32_t transferFamily;
+        uint32_t graphicsTimestampValidBits = 0;
         bool graphicsFamilyHasValue = false;
+        bool graphicsFamilyHasCompute = false;
         bool presentFamilyHasValue = false;
+        bool transferFamilyHasValue = false;
         bool isComplete() { return graphicsFamilyHasValue && presentFamilyHasValue; }
     };
 
@@ -30,7 +41,9 @@ namespace vt {
         const bool enableValidationLayers = true;
 #endif
 
-        VtDevice(VtWindow& window);
+        // A null window makes the device headless: no surface, no swapchain extension, and the
+        // graphics queue doubles as the present queue.
+        explicit VtDevice(VtWindow* window);
         ~VtDevice();
 
         // Not copyable or movable
@@ -42,33 +55,63 @@ namespace vt {
         VkCommandPool getCommandPool() { return commandPool; }
         VkDevice device() { return device_; }
         VkSurfaceKHR surface() { return surface_; }
+        bool isHeadless() { return window == nullptr; }
         VkQueue graphicsQueue() { return graphicsQueue_; }
         VkQueue presentQueue() { return presentQueue_; }
+        VkQueue transferQueue() { return transferQueue_; }
+        // vkQueueSubmit and vkQueuePresentKHR need the queue externally synchronized, and without dedicated
+        // families the present and transfer queues are the graphics queue. Hold this around every submit or
+        // present; aliased queues share one mutex.
+        std::mutex& queueMutex(VkQueue _queue);
 
         SwapChainSupportDetails getSwapChainSupport() { return querySwapChainSupport(physicalDevice); }
         uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
-        QueueFamilyIndices findPhysicalQueueFamilies() { return findQueueFamilies(physicalDevice); }
+        // Device-local memory the driver only commits when it is touched, as tile-based GPUs offer for transient attachments.
+        bool supportsLazilyAllocatedMemory();
+        QueueFamilyIndices findPhysicalQueueFamilies() { return queueFamilyIndices_; }
         VkFormat findSupportedFormat(
             const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 
         // Buffer Helper Functions
+        // sharedWithTransfer makes the buffer concurrent between the graphics and transfer families; set it
+        // for destinations of copyBuffer, which records on the transfer queue. Everything else stays exclusive.
         void createBuffer(
             VkDeviceSize size,
             VkBufferUsageFlags usage,
             VkMemoryPropertyFlags properties,
             VkBuffer& buffer,
-            VkDeviceMemory& bufferMemory);
+            VtAllocation& bufferMemory,
+            bool sharedWithTransfer = false);
+        void destroyBuffer(VkBuffer buffer, VtAllocation& bufferMemory);
         VkCommandBuffer beginSingleTimeCommands();
         void endSingleTimeCommands(VkCommandBuffer commandBuffer);
-        void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
-        void copyBufferToImage(
+        VtUploadTicket copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+        VtUploadTicket copyBufferToImage(
             VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, uint32_t layerCount);
 
+        // sharedWithTransfer as for createBuffer, for images filled through copyBufferToImage.
         void createImageWithInfo(
             const VkImageCreateInfo& imageInfo,
             VkMemoryPropertyFlags properties,
             VkImage& image,
-            VkDeviceMemory& imageMemory);
+            VtAllocation& imageMemory,
+            bool sharedWithTransfer = false);
+        void destroyImage(VkImage image, VtAllocation& imageMemory);
+
+        VtAllocator& allocator() { return *allocator_; }
+        VtAllocator::Stats getMemoryStats() { return allocator_->getStats(); }
+        VtUploadContext& uploadContext() { return *uploadContext_; }
+        VtPipelineCache& pipelineCache() { return *pipelineCache_; }
+        VtLayoutCache& layoutCache() { return *layoutCache_; }
+        // Counts frames submitted to the graphics queue. Null unless the device supports Vulkan 1.2
+        // timeline semaphores.
+        VtTimeline* graphicsTimeline() { return graphicsTimeline_.get(); }
+        // VK_EXT_swapchain_maintenance1 present fences, which tell when presentation has released a swap chain.
+        bool supportsPresentFences() { return presentFencesEnabled; }
+        // multiDrawIndirect together with drawIndirectFirstInstance, needed for one indirect command per object.
+        bool supportsMultiDrawIndirect() { return multiDrawIndirectEnabled; }
+        // Vulkan 1.2 vkCmdDraw*IndirectCount, which reads the draw count from a buffer.
+        bool supportsDrawIndirectCount() { return drawIndirectCountEnabled; }
 
         VkPhysicalDeviceProperties properties;
 
@@ -79,6 +122,11 @@ namespace vt {
         void pickPhysicalDevice();
         void createLogicalDevice();
         void createCommandPool();
+        void createAllocator();
+        void createUploadContext();
+        void createPipelineCache();
+        void createLayoutCache();
+        void createTimelines();
 
         // helper functions
         bool isDeviceSuitable(VkPhysicalDevice device);
@@ -88,21 +136,41 @@ namespace vt {
         void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo);
         void hasGflwRequiredInstanceExtensions();
         bool checkDeviceExtensionSupport(VkPhysicalDevice device);
+        // Fills in the 1.2 feature bits; false when the instance or the device is older than 1.2.
+        bool checkVulkan12Features(VkPhysicalDevice device, VkPhysicalDeviceVulkan12Features& vulkan12Features);
+        // True when the device has VK_EXT_swapchain_maintenance1 and its feature; false when the headers predate it.
+        bool checkSwapchainMaintenance1(VkPhysicalDevice device);
         SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device);
 
         VkInstance instance;
+        uint32_t instanceApiVersion = VK_API_VERSION_1_0;
         VkDebugUtilsMessengerEXT debugMessenger;
         VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
-        VtWindow& window;
+        VtWindow* window;
         VkCommandPool commandPool;
 
         VkDevice device_;
-        VkSurfaceKHR surface_;
+        QueueFamilyIndices queueFamilyIndices_;
+        VkSurfaceKHR surface_ = VK_NULL_HANDLE;
         VkQueue graphicsQueue_;
         VkQueue presentQueue_;
+        VkQueue transferQueue_;
+        std::mutex graphicsQueueMutex_;
+        std::mutex presentQueueMutex_;
+        std::mutex transferQueueMutex_;
+        std::unique_ptr<VtAllocator> allocator_;
+        std::unique_ptr<VtUploadContext> uploadContext_;
+        std::unique_ptr<VtPipelineCache> pipelineCache_;
+        std::unique_ptr<VtLayoutCache> layoutCache_;
+        bool timelineSemaphoresEnabled = false;
+        bool multiDrawIndirectEnabled = false;
+        bool drawIndirectCountEnabled = false;
+        bool surfaceMaintenanceEnabled = false;
+        bool presentFencesEnabled = false;
+        std::unique_ptr<VtTimeline> graphicsTimeline_;
 
         const std::vector<const char*> validationLayers = { "VK_LAYER_KHRONOS_validation" };
-        const std::vector<const char*> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+        std::vector<const char*> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
     };
 
 }  // namespace lve
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include "vt_indirect_culler.h"
+
+//std
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace vt {
+
+    VtIndirectCuller::Object VtIndirectCuller::Object::fromRange(const VtModel::DrawRange& _range, glm::vec2 _offset, glm::vec3 _colour) {
+        Object object{};
+        object.offset = _offset;
+        object.boundsMin = _range.bounds.min;
+        object.colour = glm::vec4{ _colour, 1.0f };
+        object.boundsMax = _range.bounds.max;
+        object.first = _range.first;
+        object.count = _range.count;
+        object.vertexOffset = _range.vertexOffset;
+        return object;
+    }
+
+    VtIndirectCuller::VtIndirectCuller(VtDevice& _device, uint32_t _frameCount, const std::vector<Object>& _objects, bool _indexed)
+        : vtDevice{ _device },
+        objectCount{ static_cast<uint32_t>(_objects.size()) },
+        groupCount{ VtComputePipeline::groupCount(static_cast<uint32_t>(_objects.size()), WORKGROUP_SIZE) },
+        indexed{ _indexed },
+        useDrawCount{ _device.supportsDrawIndirectCount() } {
+        static_assert(sizeof(Object) == 64, "Object must match the std430 layout in cull.comp");
+
+        const auto& limits = vtDevice.properties.limits;
+        if (objectCount == 0) {
+            throw std::runtime_error("GPU culling needs at least one object!");
+        }
+        if (objectCount > limits.maxDrawIndirectCount) {
+            throw std::runtime_error(std::to_string(objectCount) + " objects exceed the indirect draw count limit!");
+        }
+        if (groupCount > limits.maxComputeWorkGroupCount[0]) {
+            throw std::runtime_error(std::to_string(objectCount) + " objects exceed the compute dispatch limit!");
+        }
+
+        createObjectBuffer(_objects);
+        createDescriptorSetLayout();
+        createPipelineLayout();
+        createDescriptorPool(_frameCount);
+        createFrames(_frameCount);
+        computePipeline = std::make_unique<VtComputePipeline>(vtDevice, "shaders/cull.comp.spv", pipelineLayout);
+    }
+
+    VtIndirectCuller::~VtIndirectCuller() {
+        computePipeline.reset();
+        vtDevice.uploadContext().wait(uploadTicket);
+
+        for (auto& frame : frames) {
+            vtDevice.destroyBuffer(frame.commandBuffer, frame.commandMemory);
+            vtDevice.destroyBuffer(frame.countBuffer, frame.countMemory);
+            vtDevice.destroyBuffer(frame.readbackBuffer, frame.readbackMemory);
+        }
+        vtDevice.destroyBuffer(objectBuffer, objectMemory);
+
+        vkDestroyDescriptorPool(vtDevice.device(), descriptorPool, nullptr);
+        vkDestroyPipelineLayout(vtDevice.device(), pipelineLayout, nullptr);
+        vkDestroyDescriptorSetLayout(vtDevice.device(), descriptorSetLayout, nullptr);
+    }
+
+    bool VtIndirectCuller::isReady() {
+        return vtDevice.uploadContext().isComplete(uploadTicket);
+    }
+
+    void VtIndirectCuller::cull(VkCommandBuffer _commandBuffer, uint32_t _frameIndex, glm::vec2 _shift) {
+        Frame& frame = frames[_frameIndex];
+
+        // Without a draw count every slot is drawn, so the slots past the survivors must hold empty draws.
+        if (!useDrawCount) {
+            vkCmdFillBuffer(_commandBuffer, frame.commandBuffer, 0, VK_WHOLE_SIZE, 0);
+            VtComputePipeline::bufferBarrier(
+                _commandBuffer,
+                frame.commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_ACCESS_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VK_ACCESS_SHADER_WRITE_BIT);
+        }
+
+        PushConstantData push{};
+        push.viewBounds = glm::vec4{ -1.0f, -1.0f, 1.0f, 1.0f };
+        push.shift = _shift;
+        push.objectCount = objectCount;
+        push.indexed = indexed ? 1 : 0;
+
+        computePipeline->bind(_commandBuffer);
+        vkCmdBindDescriptorSets(_commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &frame.descriptorSet, 0, nullptr);
+
+        // Pass 0 counts the survivors of every workgroup; pass 1 sums the counts of the groups before
+        // its own to find where to write, which keeps the commands in object order.
+        push.pass = 0;
+        vkCmdPushConstants(_commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstantData), &push);
+        computePipeline->dispatch(_commandBuffer, groupCount);
+
+        VtComputePipeline::bufferBarrier(
+            _commandBuffer,
+            frame.countBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_ACCESS_SHADER_WRITE_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+        push.pass = 1;
+        vkCmdPushConstants(_commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstantData), &push);
+        computePipeline->dispatch(_commandBuffer, groupCount);
+
+        VtComputePipeline::bufferBarrier(
+            _commandBuffer,
+            frame.commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_ACCESS_SHADER_WRITE_BIT,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+            VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+        VtComputePipeline::bufferBarrier(
+            _commandBuffer,
+            frame.countBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_ACCESS_SHADER_WRITE_BIT,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT);
+
+        VkBufferCopy copyRegion{};
+        copyRegion.size = sizeof(uint32_t);
+        vkCmdCopyBuffer(_commandBuffer, frame.countBuffer, frame.readbackBuffer, 1, &copyRegion);
+        VtComputePipeline::bufferBarrier(
+            _commandBuffer,
+            frame.readbackBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_HOST_BIT,
+            VK_ACCESS_HOST_READ_BIT);
+    }
+
+    void VtIndirectCuller::draw(VkCommandBuffer _commandBuffer, uint32_t _frameIndex) {
+        Frame& frame = frames[_frameIndex];
+
+        VkBuffer buffers[] = { objectBuffer };
+        VkDeviceSize offsets[] = { 0 };
+        vkCmdBindVertexBuffers(_commandBuffer, 1, 1, buffers, offsets);
+
+        if (useDrawCount && indexed) {
+            vkCmdDrawIndexedIndirectCount(_commandBuffer, frame.commandBuffer, 0, frame.countBuffer, 0, objectCount, COMMAND_STRIDE);
+        }
+        else if (useDrawCount) {
+            vkCmdDrawIndirectCount(_commandBuffer, frame.commandBuffer, 0, frame.countBuffer, 0, objectCount, COMMAND_STRIDE);
+        }
+        else if (indexed) {
+            vkCmdDrawIndexedIndirect(_commandBuffer, frame.commandBuffer, 0, objectCount, COMMAND_STRIDE);
+        }
+        else {
+            vkCmdDrawIndirect(_commandBuffer, frame.commandBuffer, 0, objectCount, COMMAND_STRIDE);
+        }
+    }
+
+    uint32_t VtIndirectCuller::getDrawCount(uint32_t _frameIndex) const {
+        uint32_t drawCount;
+        memcpy(&drawCount, frames[_frameIndex].readbackMemory.mapped, sizeof(uint32_t));
+        return drawCount;
+    }
+
+    void VtIndirectCuller::createObjectBuffer(const std::vector<Object>& _objects) {
+        VkDeviceSize size = sizeof(Object) * _objects.size();
+
+        VkBuffer stagingBuffer;
+        VtAllocation stagingBufferMemory;
+        vtDevice.createBuffer(
+            size,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            stagingBuffer,
+            stagingBufferMemory);
+
+        memcpy(stagingBufferMemory.mapped, _objects.data(), static_cast<size_t>(size));
+
+        vtDevice.createBuffer(
+            size,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            objectBuffer,
+            objectMemory,
+            true);
+
+        uploadTicket = vtDevice.copyBuffer(stagingBuffer, objectBuffer, size);
+        vtDevice.uploadContext().onComplete(uploadTicket, [&device = vtDevice, stagingBuffer, stagingBufferMemory]() mutable {
+            device.destroyBuffer(stagingBuffer, stagingBufferMemory);
+        });
+        vtDevice.uploadContext().flush();
+    }
+
+    void VtIndirectCuller::createDescriptorSetLayout() {
+        VkDescriptorSetLayoutBinding bindings[3]{};
+        for (uint32_t i = 0; i < 3; i++) {
+            bindings[i].binding = i;
+            bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bindings[i].descriptorCount = 1;
+            bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = 3;
+        layoutInfo.pBindings = bindings;
+
+        if (vkCreateDescriptorSetLayout(vtDevice.device(), &layoutInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create descriptor set layout!");
+        }
+    }
+
+    void VtIndirectCuller::createPipelineLayout() {
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(PushConstantData);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+        if (vkCreatePipelineLayout(vtDevice.device(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline layout!");
+        }
+    }
+
+    void VtIndirectCuller::createDescriptorPool(uint32_t _frameCount) {
+        VkDescriptorPoolSize poolSize{};
+        poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSize.descriptorCount = 3 * _frameCount;
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.maxSets = _frameCount;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+
+        if (vkCreateDescriptorPool(vtDevice.device(), &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create descriptor pool!");
+        }
+    }
+
+    void VtIndirectCuller::createFrames(uint32_t _frameCount) {
+        frames.resize(_frameCount);
+        for (auto& frame : frames) {
+            vtDevice.createBuffer(
+                static_cast<VkDeviceSize>(COMMAND_STRIDE) * objectCount,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                frame.commandBuffer,
+                frame.commandMemory);
+            vtDevice.createBuffer(
+                sizeof(uint32_t) * (1 + static_cast<VkDeviceSize>(groupCount)),
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                frame.countBuffer,
+                frame.countMemory);
+            vtDevice.createBuffer(
+                sizeof(uint32_t),
+                VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                frame.readbackBuffer,
+                frame.readbackMemory);
+
+            VkDescriptorSetAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocInfo.descriptorPool = descriptorPool;
+            allocInfo.descriptorSetCount = 1;
+            allocInfo.pSetLayouts = &descriptorSetLayout;
+
+            if (vkAllocateDescriptorSets(vtDevice.device(), &allocInfo, &frame.descriptorSet) != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate descriptor set!");
+            }
+
+            VkDescriptorBufferInfo bufferInfos[3]{};
+            bufferInfos[0].buffer = objectBuffer;
+            bufferInfos[1].buffer = frame.commandBuffer;
+            bufferInfos[2].buffer = frame.countBuffer;
+
+            VkWriteDescriptorSet writes[3]{};
+            for (uint32_t i = 0; i < 3; i++) {
+                bufferInfos[i].offset = 0;
+                bufferInfos[i].range = VK_WHOLE_SIZE;
+
+                writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                writes[i].dstSet = frame.descriptorSet;
+                writes[i].dstBinding = i;
+                writes[i].descriptorCount = 1;
+                writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                writes[i].pBufferInfo = &bufferInfos[i];
+            }
+            vkUpdateDescriptorSets(vtDevice.device(), 3, writes, 0, nullptr);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "vt_device.h"
+#include "vt_compute_pipeline.h"
+#include "vt_model.h"
+
+//std
+#include <memory>
+#include <vector>
+
+namespace vt {
+
+    // GPU driven drawing of a fixed set of objects. The objects live in a DEVICE_LOCAL buffer uploaded
+    // once; every frame a compute pass culls them against the view rectangle and compacts the survivors,
+    // in object order, into indirect draw commands plus a count, and a single indirect draw renders them.
+    // Recording a frame costs the same however many objects there are.
+    class VtIndirectCuller {
+    public:
+        static constexpr uint32_t WORKGROUP_SIZE = 64;
+
+        // std430 layout shared with Shaders/cull.comp. offset and colour come first so the object buffer
+        // doubles as the per-instance stream, with each command's firstInstance picking its object.
+        struct Object {
+            glm::vec2 offset;
+            glm::vec2 boundsMin;
+            glm::vec4 colour;
+            glm::vec2 boundsMax;
+            uint32_t first;
+            uint32_t count;
+            int32_t vertexOffset;
+            uint32_t padding[3];
+
+            // An object drawing _range of the bound model at _offset.
+            static Object fromRange(const VtModel::DrawRange& _range, glm::vec2 _offset, glm::vec3 _colour);
+        };
+
+        // Throws when _objects exceed the device's indirect draw or dispatch limits.
+        VtIndirectCuller(VtDevice& _device, uint32_t _frameCount, const std::vector<Object>& _objects, bool _indexed);
+        ~VtIndirectCuller();
+
+        VtIndirectCuller(const VtIndirectCuller&) = delete;
+        VtIndirectCuller& operator=(const VtIndirectCuller&) = delete;
+
+        // False until the object upload has retired on the transfer queue.
+        bool isReady();
+
+        // Records the culling dispatches for the frame, outside of a render pass. _shift moves every
+        // object, so animating them does not need a new upload.
+        void cull(VkCommandBuffer _commandBuffer, uint32_t _frameIndex, glm::vec2 _shift);
+        // Binds the object stream and draws the survivors of the frame's cull; the model must be bound.
+        void draw(VkCommandBuffer _commandBuffer, uint32_t _frameIndex);
+        // Survivors of the frame's last cull, read back without waiting. Only meaningful once the
+        // frame's fence has signalled since that cull was submitted.
+        uint32_t getDrawCount(uint32_t _frameIndex) const;
+
+    private:
+        struct PushConstantData {
+            glm::vec4 viewBounds;
+            glm::vec2 shift;
+            uint32_t objectCount;
+            uint32_t indexed;
+            uint32_t pass;
+        };
+
+        // Commands are five uints whether indexed or not, so both layouts share one buffer and stride.
+        static constexpr uint32_t COMMAND_STRIDE = sizeof(VkDrawIndexedIndirectCommand);
+
+        struct Frame {
+            VkBuffer commandBuffer = VK_NULL_HANDLE;
+            VtAllocation commandMemory{};
+            // The draw count, followed by one survivor count per workgroup.
+            VkBuffer countBuffer = VK_NULL_HANDLE;
+            VtAllocation countMemory{};
+            // Host visible copy of the draw count, for reporting what the frame actually drew.
+            VkBuffer readbackBuffer = VK_NULL_HANDLE;
+            VtAllocation readbackMemory{};
+            VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        };
+
+        void createObjectBuffer(const std::vector<Object>& _objects);
+        void createDescriptorSetLayout();
+        void createPipelineLayout();
+        void createDescriptorPool(uint32_t _frameCount);
+        void createFrames(uint32_t _frameCount);
+
+        VtDevice& vtDevice;
+        uint32_t objectCount;
+        uint32_t groupCount;
+        bool indexed;
+        bool useDrawCount;
+
+        VkBuffer objectBuffer = VK_NULL_HANDLE;
+        VtAllocation objectMemory{};
+        VtUploadTicket uploadTicket;
+
+        std::vector<Frame> frames;
+        VkDescriptorSetLayout descriptorSetLayout;
+        VkPipelineLayout pipelineLayout;
+        VkDescriptorPool descriptorPool;
+        std::unique_ptr<VtComputePipeline> computePipeline;
+    };
+
+    // Per-instance offset and colour at binding 1, locations 2 and 3, as with VtModel::Instance.
+    template <>
+    struct VtVertexInputTraits<VtIndirectCuller::Object> {
+        static constexpr std::array<VkVertexInputBindingDescription, 1> bindings{ {
+            { 1, sizeof(VtIndirectCuller::Object), VK_VERTEX_INPUT_RATE_INSTANCE },
+        } };
+        static constexpr std::array<VkVertexInputAttributeDescription, 2> attributes{ {
+            { 2, 1, VK_FORMAT_R32G32_SFLOAT, offsetof(VtIndirectCuller::Object, offset) },
+            { 3, 1, VK_FORMAT_R32G32B32_SFLOAT, offsetof(VtIndirectCuller::Object, colour) },
+        } };
+    };
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "vt_instance_buffer.h"
+
+//std
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace vt {
+
+    VtInstanceBuffer::VtInstanceBuffer(VtDevice& _device, uint32_t _frameCount) : vtDevice{ _device }, frames(_frameCount) {}
+
+    VtInstanceBuffer::~VtInstanceBuffer() {
+        for (auto& frame : frames) {
+            if (frame.buffer != VK_NULL_HANDLE) {
+                vtDevice.destroyBuffer(frame.buffer, frame.memory);
+            }
+        }
+    }
+
+    void VtInstanceBuffer::write(uint32_t _frameIndex, const std::vector<VtModel::Instance>& _instances) {
+        assert(_frameIndex < frames.size() && "Frame index out of range");
+
+        Frame& frame = frames[_frameIndex];
+        VkDeviceSize size = sizeof(VtModel::Instance) * std::max<size_t>(_instances.size(), 1);
+
+        if (size > frame.capacity) {
+            if (frame.buffer != VK_NULL_HANDLE) {
+                vtDevice.destroyBuffer(frame.buffer, frame.memory);
+            }
+
+            frame.capacity = std::max(size, frame.capacity * 2);
+            vtDevice.createBuffer(
+                frame.capacity,
+                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                frame.buffer,
+                frame.memory);
+        }
+
+        memcpy(frame.memory.mapped, _instances.data(), sizeof(VtModel::Instance) * _instances.size());
+    }
+
+    void VtInstanceBuffer::bind(VkCommandBuffer _commandBuffer, uint32_t _frameIndex) {
+        VkBuffer buffers[] = { frames[_frameIndex].buffer };
+        VkDeviceSize offsets[] = { 0 };
+        vkCmdBindVertexBuffers(_commandBuffer, 1, 1, buffers, offsets);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "vt_device.h"
+#include "vt_model.h"
+
+//std
+#include <vector>
+
+namespace vt {
+
+    // Host visible per-instance stream, one buffer per frame in flight so the CPU can rewrite the
+    // next frame's instances while the GPU still reads the previous ones.
+    class VtInstanceBuffer {
+    public:
+        VtInstanceBuffer(VtDevice& _device, uint32_t _frameCount);
+        ~VtInstanceBuffer();
+
+        VtInstanceBuffer(const VtInstanceBuffer&) = delete;
+        VtInstanceBuffer& operator=(const VtInstanceBuffer&) = delete;
+
+        // Only call once the frame's fence has signalled; grows the frame's buffer if needed.
+        void write(uint32_t _frameIndex, const std::vector<VtModel::Instance>& _instances);
+        void bind(VkCommandBuffer _commandBuffer, uint32_t _frameIndex);
+
+    private:
+        struct Frame {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VtAllocation memory{};
+            VkDeviceSize capacity = 0;
+        };
+
+        VtDevice& vtDevice;
+        std::vector<Frame> frames;
+    };
+}
\ No newline at end of file
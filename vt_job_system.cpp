@@ -0,0 +1,164 @@
+#include "vt_job_system.h"
+
+namespace vt {
+
+    namespace {
+        // Lets a job find its worker's own deque without passing the index through every spawn.
+        thread_local const VtJobSystem* currentSystem = nullptr;
+        thread_local uint32_t currentWorkerQueue = 0;
+    }
+
+    VtJobSystem::VtJobSystem(uint32_t _workerCount) {
+        for (uint32_t i = 0; i <= _workerCount; i++) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        for (uint32_t i = 0; i < _workerCount; i++) {
+            threads.emplace_back(&VtJobSystem::workerLoop, this, i + 1);
+        }
+    }
+
+    VtJobSystem::~VtJobSystem() {
+        {
+            std::lock_guard<std::mutex> lock{ sleepMutex };
+            stopping = true;
+        }
+        workAvailable.notify_all();
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void VtJobSystem::spawn(VtJobCounter& _counter, std::function<void()> _job) {
+        _counter.pending.fetch_add(1, std::memory_order_relaxed);
+        push({ std::move(_job), &_counter });
+    }
+
+    void VtJobSystem::spawnAfter(VtJobCounter& _dependency, VtJobCounter& _counter, std::function<void()> _job) {
+        _counter.pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            // finish() drops the count under this lock, so the job is either parked here or the dependency is already idle.
+            std::lock_guard<std::mutex> lock{ _dependency.mutex };
+            if (!_dependency.isDone()) {
+                _dependency.continuations.push_back({ std::move(_job), &_counter });
+                return;
+            }
+        }
+        push({ std::move(_job), &_counter });
+    }
+
+    void VtJobSystem::wait(VtJobCounter& _counter) {
+        while (!_counter.isDone()) {
+            if (!runOne()) {
+                std::this_thread::yield();
+            }
+        }
+
+        // Taking the lock also waits out the last finish(), after which the counter is safe to destroy.
+        std::exception_ptr failure;
+        {
+            std::lock_guard<std::mutex> lock{ _counter.mutex };
+            std::swap(failure, _counter.failure);
+        }
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    void VtJobSystem::push(Job _job) {
+        {
+            Queue& queue = *queues[currentQueue()];
+            std::lock_guard<std::mutex> lock{ queue.mutex };
+            queue.jobs.push_back(std::move(_job));
+        }
+        queuedJobs.fetch_add(1, std::memory_order_release);
+
+        // An empty critical section orders the count against a worker that is just about to sleep.
+        { std::lock_guard<std::mutex> lock{ sleepMutex }; }
+        workAvailable.notify_one();
+    }
+
+    bool VtJobSystem::runOne() {
+        uint32_t queue = currentQueue();
+        Job job;
+        if (!pop(queue, job) && !steal(queue, job)) {
+            return false;
+        }
+        queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+        std::exception_ptr failure;
+        try {
+            job.function();
+        }
+        catch (...) {
+            failure = std::current_exception();
+        }
+        finish(*job.counter, failure);
+        return true;
+    }
+
+    bool VtJobSystem::pop(uint32_t _queue, Job& _job) {
+        // Newest first: it is the most likely to still be in this core's cache.
+        Queue& queue = *queues[_queue];
+        std::lock_guard<std::mutex> lock{ queue.mutex };
+        if (queue.jobs.empty()) {
+            return false;
+        }
+        _job = std::move(queue.jobs.back());
+        queue.jobs.pop_back();
+        return true;
+    }
+
+    bool VtJobSystem::steal(uint32_t _queue, Job& _job) {
+        // Oldest first: in recursive splits that is the biggest remaining piece of work.
+        for (size_t offset = 1; offset < queues.size(); offset++) {
+            Queue& queue = *queues[(_queue + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock{ queue.mutex };
+            if (!queue.jobs.empty()) {
+                _job = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void VtJobSystem::finish(VtJobCounter& _counter, std::exception_ptr _failure) {
+        std::vector<VtJobCounter::Continuation> ready;
+        {
+            std::lock_guard<std::mutex> lock{ _counter.mutex };
+            if (_failure && !_counter.failure) {
+                _counter.failure = _failure;
+            }
+            if (_counter.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                ready.swap(_counter.continuations);
+            }
+        }
+
+        // _counter may already be gone here; the continuations keep their own counters busy.
+        for (auto& continuation : ready) {
+            push({ std::move(continuation.job), continuation.counter });
+        }
+    }
+
+    void VtJobSystem::workerLoop(uint32_t _queue) {
+        currentSystem = this;
+        currentWorkerQueue = _queue;
+
+        while (true) {
+            if (runOne()) {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock{ sleepMutex };
+            workAvailable.wait(lock, [this] { return stopping || queuedJobs.load(std::memory_order_acquire) > 0; });
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+    uint32_t VtJobSystem::currentQueue() const {
+        return currentSystem == this ? currentWorkerQueue : 0;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+//std
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vt {
+
+    // Tracks a group of jobs. Jobs spawned against it keep it busy until they finish, and jobs spawned
+    // after it only start once it is idle. Only destroy a counter after VtJobSystem::wait returned on it.
+    class VtJobCounter {
+    public:
+        VtJobCounter() = default;
+
+        VtJobCounter(const VtJobCounter&) = delete;
+        VtJobCounter& operator=(const VtJobCounter&) = delete;
+
+        bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class VtJobSystem;
+
+        struct Continuation {
+            std::function<void()> job;
+            VtJobCounter* counter;
+        };
+
+        std::atomic<uint32_t> pending{ 0 };
+        std::mutex mutex;
+        std::vector<Continuation> continuations;
+        std::exception_ptr failure;
+    };
+
+    // Work-stealing scheduler. Every worker owns a deque: it pushes and pops its own jobs at the back
+    // and, when empty, steals the oldest job from the front of another's. Threads outside the pool
+    // share one extra deque, and help run jobs while they wait instead of blocking.
+    class VtJobSystem {
+    public:
+        // With no workers at all, jobs run on whichever thread waits for them.
+        explicit VtJobSystem(uint32_t _workerCount = defaultWorkerCount());
+        ~VtJobSystem();
+
+        VtJobSystem(const VtJobSystem&) = delete;
+        VtJobSystem& operator=(const VtJobSystem&) = delete;
+
+        void spawn(VtJobCounter& _counter, std::function<void()> _job);
+        // Runs _job once _dependency is idle; _counter is busy from now until _job has finished.
+        void spawnAfter(VtJobCounter& _dependency, VtJobCounter& _counter, std::function<void()> _job);
+
+        // Runs queued jobs until _counter is idle, then rethrows the first exception one of its jobs threw.
+        void wait(VtJobCounter& _counter);
+
+        // Calls _body(begin, end) over [_begin, _end) in chunks of at most _grainSize and waits for all of them.
+        template <typename Body>
+        void parallelFor(uint32_t _begin, uint32_t _end, uint32_t _grainSize, Body&& _body) {
+            VtJobCounter counter;
+            uint32_t grainSize = std::max(1u, _grainSize);
+            for (uint32_t begin = _begin; begin < _end;) {
+                uint32_t end = begin + std::min(grainSize, _end - begin);
+                spawn(counter, [&_body, begin, end]() { _body(begin, end); });
+                begin = end;
+            }
+            wait(counter);
+        }
+
+        uint32_t workerCount() const { return static_cast<uint32_t>(threads.size()); }
+
+        // One worker per hardware thread, less the calling thread, which helps out in wait().
+        static uint32_t defaultWorkerCount() { return std::max(1u, std::thread::hardware_concurrency()) - 1; }
+
+    private:
+        struct Job {
+            std::function<void()> function;
+            VtJobCounter* counter = nullptr;
+        };
+
+        struct Queue {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+
+        void push(Job _job);
+        bool runOne();
+        bool pop(uint32_t _queue, Job& _job);
+        bool steal(uint32_t _queue, Job& _job);
+        void finish(VtJobCounter& _counter, std::exception_ptr _failure);
+        void workerLoop(uint32_t _queue);
+        uint32_t currentQueue() const;
+
+        // Queue 0 is shared by threads outside the pool, worker i owns queue i + 1.
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> threads;
+
+        std::atomic<uint32_t> queuedJobs{ 0 };
+        std::mutex sleepMutex;
+        std::condition_variable workAvailable;
+        bool stopping = false;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "vt_layout_cache.h"
+
+//std
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+
+namespace vt {
+
+    namespace {
+
+        void sortBindings(std::vector<VkDescriptorSetLayoutBinding>& _bindings) {
+            std::sort(_bindings.begin(), _bindings.end(), [](const VkDescriptorSetLayoutBinding& _a, const VkDescriptorSetLayoutBinding& _b) {
+                return _a.binding < _b.binding;
+            });
+        }
+
+        // Appends sorted _bindings to _key, prefixed with their count so consecutive sets cannot run together.
+        void appendBindings(std::vector<uint64_t>& _key, const std::vector<VkDescriptorSetLayoutBinding>& _bindings) {
+            _key.push_back(_bindings.size());
+            for (const VkDescriptorSetLayoutBinding& binding : _bindings) {
+                assert(binding.pImmutableSamplers == nullptr && "Immutable samplers are not part of the cached signature");
+                _key.push_back(binding.binding);
+                _key.push_back(static_cast<uint64_t>(binding.descriptorType));
+                _key.push_back(binding.descriptorCount);
+                _key.push_back(binding.stageFlags);
+            }
+        }
+    }
+
+    VtLayoutCache::VtLayoutCache(VkDevice _device) : device{ _device } {}
+
+    VtLayoutCache::~VtLayoutCache() {
+        // Pipeline layouts first, they were created from the set layouts.
+        for (auto& entry : pipelineLayouts) {
+            vkDestroyPipelineLayout(device, entry.second, nullptr);
+        }
+        for (auto& entry : descriptorSetLayouts) {
+            vkDestroyDescriptorSetLayout(device, entry.second, nullptr);
+        }
+    }
+
+    VkDescriptorSetLayout VtLayoutCache::getDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutBinding>& _bindings) {
+        std::lock_guard<std::mutex> lock{ mutex };
+        return getDescriptorSetLayoutLocked(_bindings);
+    }
+
+    VkDescriptorSetLayout VtLayoutCache::getDescriptorSetLayoutLocked(std::vector<VkDescriptorSetLayoutBinding> _bindings) {
+        sortBindings(_bindings);
+        Key key;
+        appendBindings(key, _bindings);
+
+        auto cached = descriptorSetLayouts.find(key);
+        if (cached != descriptorSetLayouts.end()) {
+            reusedCount++;
+            return cached->second;
+        }
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = static_cast<uint32_t>(_bindings.size());
+        layoutInfo.pBindings = _bindings.data();
+
+        VkDescriptorSetLayout layout;
+        if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &layout) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create descriptor set layout!");
+        }
+        descriptorSetLayouts.emplace(std::move(key), layout);
+        return layout;
+    }
+
+    VkPipelineLayout VtLayoutCache::getPipelineLayout(const VtShaderReflection& _reflection) {
+        std::lock_guard<std::mutex> lock{ mutex };
+
+        const auto& descriptorBindings = _reflection.getDescriptorBindings();
+        const auto& pushConstantRanges = _reflection.getPushConstantRanges();
+        uint32_t setCount = descriptorBindings.empty() ? 0 : descriptorBindings.back().set + 1;
+
+        std::vector<std::vector<VkDescriptorSetLayoutBinding>> setBindings(setCount);
+        for (const auto& binding : descriptorBindings) {
+            setBindings[binding.set].push_back({ binding.binding, binding.type, binding.count, binding.stages, nullptr });
+        }
+
+        Key key;
+        key.push_back(setCount);
+        for (auto& bindings : setBindings) {
+            sortBindings(bindings);
+            appendBindings(key, bindings);
+        }
+        for (const VkPushConstantRange& range : pushConstantRanges) {
+            key.push_back(range.stageFlags);
+            key.push_back(range.offset);
+            key.push_back(range.size);
+        }
+
+        auto cached = pipelineLayouts.find(key);
+        if (cached != pipelineLayouts.end()) {
+            reusedCount++;
+            return cached->second;
+        }
+
+        std::vector<VkDescriptorSetLayout> setLayouts(setCount);
+        for (uint32_t set = 0; set < setCount; set++) {
+            setLayouts[set] = getDescriptorSetLayoutLocked(setBindings[set]);
+        }
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = setCount;
+        pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+        pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+        pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges.data();
+
+        VkPipelineLayout layout;
+        if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &layout) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline layout!");
+        }
+        pipelineLayouts.emplace(std::move(key), layout);
+        return layout;
+    }
+
+    void VtLayoutCache::reportReuse() {
+        std::lock_guard<std::mutex> lock{ mutex };
+        std::cout << "Layout cache: " << descriptorSetLayouts.size() << " descriptor set layouts and " << pipelineLayouts.size()
+            << " pipeline layouts created, " << reusedCount << " requests reused an existing one" << std::endl;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "vt_shader_reflection.h"
+
+//vulkan
+#include <vulkan/vulkan.h>
+
+//std
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace vt {
+
+    // Owns every descriptor set layout and pipeline layout the device's pipelines use, deduplicated by
+    // signature: pipelines whose shaders declare the same interface share one layout instead of each
+    // creating their own. Layouts live as long as the cache, so callers never destroy them.
+    class VtLayoutCache {
+    public:
+        explicit VtLayoutCache(VkDevice _device);
+        ~VtLayoutCache();
+
+        VtLayoutCache(const VtLayoutCache&) = delete;
+        VtLayoutCache& operator=(const VtLayoutCache&) = delete;
+
+        // The set layout for _bindings, whatever order they are listed in.
+        VkDescriptorSetLayout getDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutBinding>& _bindings);
+        // The pipeline layout for a reflected signature: one set layout for every set up to the highest
+        // used, empty where a set is skipped, followed by the push-constant ranges.
+        VkPipelineLayout getPipelineLayout(const VtShaderReflection& _reflection);
+
+        // How many layouts were created against how many requests found one already cached.
+        void reportReuse();
+
+    private:
+        // Signatures flattened to words, so equal interfaces compare equal however they were described.
+        using Key = std::vector<uint64_t>;
+
+        VkDescriptorSetLayout getDescriptorSetLayoutLocked(std::vector<VkDescriptorSetLayoutBinding> _bindings);
+
+        VkDevice device;
+        std::mutex mutex;
+        std::map<Key, VkDescriptorSetLayout> descriptorSetLayouts;
+        std::map<Key, VkPipelineLayout> pipelineLayouts;
+        uint32_t reusedCount = 0;
+    };
+}
\ No newline at end of file
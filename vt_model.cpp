@@ -1,66 +1,219 @@
 #include "vt_model.h"
 
+#include "vt_compute_pipeline.h"
+
 #include <cassert>
 #include <cstring>
+#include <functional>
+#include <limits>
 
 namespace vt {
 
-    VtModel::VtModel(VtDevice& _device, const std::vector<Vertex>& _vertices) : vtDevice{ _device } {
+    VtModel::VtModel(VtDevice& _device, const std::vector<Vertex>& _vertices, Usage _usage, VtVertexFormat _format)
+        : vtDevice{ _device }, usage{ _usage }, vertexFormat{ _format } {
         createVertexBuffers(_vertices);
     }
 
+    VtModel::VtModel(VtDevice& _device, const Builder& _builder, Usage _usage, VtVertexFormat _format)
+        : vtDevice{ _device }, usage{ _usage }, vertexFormat{ _format } {
+        createVertexBuffers(_builder.vertices);
+        createIndexBuffers(_builder.indices);
+    }
+
+    VtModel::VtModel(VtDevice& _device, uint32_t _vertexCount, const Bounds& _bounds, const Generator& _generate)
+        : vtDevice{ _device }, usage{ Usage::Static }, vertexCount{ _vertexCount }, bounds{ _bounds } {
+        assert(vertexCount >= 3 && "Vertex count must be at least 3");
+
+        vtDevice.createBuffer(
+            sizeof(Vertex) * vertexCount,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            vertexBuffer,
+            vertexBufferMemory);
+
+        VkCommandBuffer commandBuffer = vtDevice.beginSingleTimeCommands();
+        _generate(commandBuffer, vertexBuffer);
+        VtComputePipeline::bufferBarrier(
+            commandBuffer,
+            vertexBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_ACCESS_SHADER_WRITE_BIT,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+            VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+        vtDevice.endSingleTimeCommands(commandBuffer);
+    }
+
     VtModel::~VtModel() {
-        vkDestroyBuffer(vtDevice.device(), vertexBuffer, nullptr);
-        vkFreeMemory(vtDevice.device(), vertexBufferMemory, nullptr);
+        vtDevice.uploadContext().wait(uploadTicket);
+        vtDevice.destroyBuffer(vertexBuffer, vertexBufferMemory);
+
+        if (hasIndexBuffer) {
+            vtDevice.destroyBuffer(indexBuffer, indexBufferMemory);
+        }
     }
 
-    std::vector<VkVertexInputBindingDescription> VtModel::Vertex::getBindingDescriptions() {
-        std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
-        bindingDescriptions[0].binding = 0;
-        bindingDescriptions[0].stride = sizeof(Vertex);
-        bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        return bindingDescriptions;
+    size_t VtModel::Vertex::Hash::operator()(const Vertex& _vertex) const {
+        // std::hash<float> maps -0.0f and 0.0f to the same value, keeping the hash consistent with operator==.
+        std::hash<float> hasher{};
+        size_t seed = 0;
+        for (float value : { _vertex.position.x, _vertex.position.y, _vertex.colour.x, _vertex.colour.y, _vertex.colour.z }) {
+            seed ^= hasher(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        }
+        return seed;
     }
 
-    std::vector<VkVertexInputAttributeDescription> VtModel::Vertex::getAttributeDescriptions() {
-        std::vector<VkVertexInputAttributeDescription> attributeDescriptions(2);
-        attributeDescriptions[0].binding = 0;
-        attributeDescriptions[0].location = 0;
-        attributeDescriptions[0].format = VK_FORMAT_R32G32_SFLOAT;
-        attributeDescriptions[0].offset = offsetof(Vertex, position);
+    void VtModel::Builder::addVertex(const Vertex& _vertex) {
+        auto [it, inserted] = lookup.try_emplace(_vertex, static_cast<uint32_t>(vertices.size()));
+        if (inserted) {
+            vertices.push_back(_vertex);
+        }
+        indices.push_back(it->second);
+    }
+
+    void VtModel::Builder::append(const Builder& _other) {
+        std::vector<uint32_t> remap(_other.vertices.size());
+        for (size_t i = 0; i < _other.vertices.size(); i++) {
+            auto [it, inserted] = lookup.try_emplace(_other.vertices[i], static_cast<uint32_t>(vertices.size()));
+            if (inserted) {
+                vertices.push_back(_other.vertices[i]);
+            }
+            remap[i] = it->second;
+        }
+
+        indices.reserve(indices.size() + _other.indices.size());
+        for (uint32_t index : _other.indices) {
+            indices.push_back(remap[index]);
+        }
+    }
 
-        attributeDescriptions[1].binding = 0;
-        attributeDescriptions[1].location = 1;
-        attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-        attributeDescriptions[1].offset = offsetof(Vertex, colour);
-        return attributeDescriptions;
+    VtModel::Builder VtModel::Builder::fromVertices(const std::vector<Vertex>& _vertices) {
+        Builder builder{};
+        builder.indices.reserve(_vertices.size());
+        for (const auto& vertex : _vertices) {
+            builder.addVertex(vertex);
+        }
+        return builder;
     }
 
     void VtModel::bind(VkCommandBuffer _commandBuffer) {
         VkBuffer buffers[] = { vertexBuffer };
         VkDeviceSize offsets[] = { 0 };
         vkCmdBindVertexBuffers(_commandBuffer, 0, 1, buffers, offsets);
+
+        if (hasIndexBuffer) {
+            vkCmdBindIndexBuffer(_commandBuffer, indexBuffer, 0, indexType);
+        }
     }
 
     void VtModel::draw(VkCommandBuffer _commandBuffer) {
-        vkCmdDraw(_commandBuffer, vertexCount, 1, 0, 0);
+        drawInstanced(_commandBuffer, 1);
+    }
+
+    void VtModel::drawInstanced(VkCommandBuffer _commandBuffer, uint32_t _instanceCount, uint32_t _firstInstance) {
+        if (hasIndexBuffer) {
+            vkCmdDrawIndexed(_commandBuffer, indexCount, _instanceCount, 0, 0, _firstInstance);
+        }
+        else {
+            vkCmdDraw(_commandBuffer, vertexCount, _instanceCount, 0, _firstInstance);
+        }
+    }
+
+    bool VtModel::isReady() {
+        return vtDevice.uploadContext().isComplete(uploadTicket);
+    }
+
+    void VtModel::updateVertices(const std::vector<Vertex>& _vertices) {
+        assert(usage == Usage::Dynamic && "Only dynamic models can be updated in place");
+        assert(_vertices.size() == vertexCount && "Vertex count of a dynamic model cannot change");
+
+        std::vector<uint8_t> encoded = encodeVertices(_vertices);
+        memcpy(vertexBufferMemory.mapped, encoded.data(), encoded.size());
+        bounds = computeBounds(_vertices);
     }
 
     void VtModel::createVertexBuffers(const std::vector<Vertex>& _vertices) {
         vertexCount = static_cast<uint32_t>(_vertices.size());
         assert(vertexCount >= 3 && "Vertex count must be at least 3");
-        VkDeviceSize BufferSize = sizeof(_vertices[0]) * vertexCount;
+        bounds = computeBounds(_vertices);
+        std::vector<uint8_t> encoded = encodeVertices(_vertices);
+        VkDeviceSize BufferSize = encoded.size();
+
+        if (usage == Usage::Dynamic) {
+            vtDevice.createBuffer(
+                BufferSize,
+                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                vertexBuffer,
+                vertexBufferMemory);
+
+            memcpy(vertexBufferMemory.mapped, encoded.data(), static_cast<size_t>(BufferSize));
+            return;
+        }
+
+        uploadToDeviceLocal(encoded.data(), BufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer, vertexBufferMemory);
+    }
+
+    VtModel::Bounds VtModel::computeBounds(const std::vector<Vertex>& _vertices) {
+        Bounds result{ _vertices[0].position, _vertices[0].position };
+        for (const auto& vertex : _vertices) {
+            result.min = glm::min(result.min, vertex.position);
+            result.max = glm::max(result.max, vertex.position);
+        }
+        return result;
+    }
 
+    std::vector<uint8_t> VtModel::encodeVertices(const std::vector<Vertex>& _vertices) const {
+        return visitVertexFormat(vertexFormat, [&](auto _layout) {
+            return vt::encodeVertices<decltype(_layout)>(
+                _vertices.size(),
+                [&](size_t _index) { return _vertices[_index].position; },
+                [&](size_t _index) { return _vertices[_index].colour; });
+        });
+    }
+
+    void VtModel::createIndexBuffers(const std::vector<uint32_t>& _indices) {
+        indexCount = static_cast<uint32_t>(_indices.size());
+        hasIndexBuffer = indexCount > 0;
+        if (!hasIndexBuffer) {
+            return;
+        }
+
+        // 16-bit indices halve index fetch bandwidth whenever every vertex is addressable with them.
+        if (vertexCount <= std::numeric_limits<uint16_t>::max()) {
+            std::vector<uint16_t> shortIndices(_indices.begin(), _indices.end());
+            indexType = VK_INDEX_TYPE_UINT16;
+            uploadToDeviceLocal(shortIndices.data(), sizeof(uint16_t) * indexCount, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer, indexBufferMemory);
+        }
+        else {
+            indexType = VK_INDEX_TYPE_UINT32;
+            uploadToDeviceLocal(_indices.data(), sizeof(uint32_t) * indexCount, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer, indexBufferMemory);
+        }
+    }
+
+    void VtModel::uploadToDeviceLocal(const void* _data, VkDeviceSize _size, VkBufferUsageFlags _usage, VkBuffer& _buffer, VtAllocation& _memory) {
+        VkBuffer stagingBuffer;
+        VtAllocation stagingBufferMemory;
         vtDevice.createBuffer(
-            BufferSize,
-            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            _size,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            vertexBuffer,
-            vertexBufferMemory);
+            stagingBuffer,
+            stagingBufferMemory);
+
+        memcpy(stagingBufferMemory.mapped, _data, static_cast<size_t>(_size));
+
+        vtDevice.createBuffer(
+            _size,
+            _usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            _buffer,
+            _memory,
+            true);
 
-        void* data;
-        vkMapMemory(vtDevice.device(), vertexBufferMemory, 0, BufferSize, 0, &data);
-        memcpy(data, _vertices.data(), static_cast<size_t>(BufferSize));
-        vkUnmapMemory(vtDevice.device(), vertexBufferMemory);
+        // Both copies land in the same open batch, so the later ticket covers the whole model.
+        uploadTicket = vtDevice.copyBuffer(stagingBuffer, _buffer, _size);
+        vtDevice.uploadContext().onComplete(uploadTicket, [&device = vtDevice, stagingBuffer, stagingBufferMemory]() mutable {
+            device.destroyBuffer(stagingBuffer, stagingBufferMemory);
+        });
     }
 }
\ No newline at end of file
@@ -1,11 +1,17 @@
 #pragma once
 
 #include "vt_device.h"
+#include "vt_vertex_format.h"
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 
+//std
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
 namespace vt {
 
     class VtModel {
@@ -15,11 +21,63 @@ namespace vt {
             glm::vec2 position;
             glm::vec3 colour;
 
-            static std::vector<VkVertexInputBindingDescription> getBindingDescriptions();
-            static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
+            bool operator==(const Vertex& _other) const { return position == _other.position && colour == _other.colour; }
+
+            struct Hash {
+                size_t operator()(const Vertex& _vertex) const;
+            };
+        };
+
+        // Per-instance attribute stream read from binding 1, mirroring SimplePushConstantData.
+        struct Instance {
+            glm::vec2 offset;
+            glm::vec3 colour;
+        };
+
+        // Collects indexed geometry, welding bit-identical vertices through a hash lookup so shared
+        // corners are stored once and the post-transform cache can reuse them.
+        struct Builder {
+            std::vector<Vertex> vertices{};
+            std::vector<uint32_t> indices{};
+
+            void addVertex(const Vertex& _vertex);
+            // Adds _other's triangles as if its vertices had been added here one by one, welding across both.
+            void append(const Builder& _other);
+            static Builder fromVertices(const std::vector<Vertex>& _vertices);
+
+        private:
+            std::unordered_map<Vertex, uint32_t, Vertex::Hash> lookup{};
+        };
+
+        // Model space bounding rectangle of the vertex positions.
+        struct Bounds {
+            glm::vec2 min{ 0.0f };
+            glm::vec2 max{ 0.0f };
+        };
+
+        // Everything a draw recorded on the GPU needs: the index range for indexed models, the vertex
+        // range otherwise, and the bounds to cull against.
+        struct DrawRange {
+            uint32_t first = 0;
+            uint32_t count = 0;
+            int32_t vertexOffset = 0;
+            Bounds bounds{};
         };
 
-        VtModel(VtDevice& _device, const std::vector<Vertex>& _vertices);
+        // Static geometry is uploaded once into DEVICE_LOCAL memory through a staging buffer.
+        // Dynamic geometry stays in mapped HOST_VISIBLE memory so updateVertices can rewrite it in place,
+        // without a staging copy. There is a single copy of it, see updateVertices.
+        enum class Usage { Static, Dynamic };
+
+        // Vertices are authored as Vertex and converted to _format as the buffers are built; compact
+        // formats trade precision for vertex fetch bandwidth and memory, see vt_vertex_format.h.
+        VtModel(VtDevice& _device, const std::vector<Vertex>& _vertices, Usage _usage = Usage::Static, VtVertexFormat _format = VtVertexFormat::Float);
+        VtModel(VtDevice& _device, const Builder& _builder, Usage _usage = Usage::Static, VtVertexFormat _format = VtVertexFormat::Float);
+
+        // Geometry written on the GPU: _generate records commands that fill the DEVICE_LOCAL vertex buffer,
+        // bound as a storage buffer, with _vertexCount Float vertices inside _bounds. Runs once on the graphics queue and waits.
+        using Generator = std::function<void(VkCommandBuffer _commandBuffer, VkBuffer _vertexBuffer)>;
+        VtModel(VtDevice& _device, uint32_t _vertexCount, const Bounds& _bounds, const Generator& _generate);
         ~VtModel();
 
         VtModel(const VtModel&) = delete;
@@ -27,13 +85,71 @@ namespace vt {
 
         void bind(VkCommandBuffer _commandBuffer);
         void draw(VkCommandBuffer _commandBuffer);
+        void drawInstanced(VkCommandBuffer _commandBuffer, uint32_t _instanceCount, uint32_t _firstInstance = 0);
+
+        // Overwrites the one mapped vertex buffer of a dynamic model, which every submitted frame that drew
+        // it is still reading. Callers must first wait for all frames in flight to retire, so this suits
+        // occasional edits rather than per-frame animation.
+        void updateVertices(const std::vector<Vertex>& _vertices);
+
+        // False until the vertex upload batch has retired on the transfer queue.
+        bool isReady();
+
+        uint32_t getTriangleCount() const { return (hasIndexBuffer ? indexCount : vertexCount) / 3; }
+        bool isIndexed() const { return hasIndexBuffer; }
+        VtVertexFormat getVertexFormat() const { return vertexFormat; }
+        // Vertex input for pipelines drawing this model: its vertex format at binding 0, followed by
+        // Streams such as Instance. Every combination is described at compile time; this only picks one.
+        template <typename... Streams>
+        VtVertexInput getVertexInput() const {
+            return visitVertexFormat(vertexFormat, [](auto _layout) { return vertexInputOf<decltype(_layout), Streams...>; });
+        }
+        const Bounds& getBounds() const { return bounds; }
+        DrawRange getDrawRange() const { return DrawRange{ 0, hasIndexBuffer ? indexCount : vertexCount, 0, bounds }; }
 
     private:
         void createVertexBuffers(const std::vector<Vertex>& _vertices);
+        static Bounds computeBounds(const std::vector<Vertex>& _vertices);
+        std::vector<uint8_t> encodeVertices(const std::vector<Vertex>& _vertices) const;
+        void createIndexBuffers(const std::vector<uint32_t>& _indices);
+        void uploadToDeviceLocal(const void* _data, VkDeviceSize _size, VkBufferUsageFlags _usage, VkBuffer& _buffer, VtAllocation& _memory);
 
         VtDevice& vtDevice;
+        Usage usage;
+        VtVertexFormat vertexFormat = VtVertexFormat::Float;
         VkBuffer vertexBuffer;
-        VkDeviceMemory vertexBufferMemory;
+        VtAllocation vertexBufferMemory;
         uint32_t vertexCount;
+        Bounds bounds{};
+
+        bool hasIndexBuffer = false;
+        VkBuffer indexBuffer = VK_NULL_HANDLE;
+        VtAllocation indexBufferMemory;
+        uint32_t indexCount = 0;
+        VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+
+        VtUploadTicket uploadTicket;
+    };
+
+    template <>
+    struct VtVertexInputTraits<VtModel::Vertex> {
+        static constexpr std::array<VkVertexInputBindingDescription, 1> bindings{ {
+            { 0, sizeof(VtModel::Vertex), VK_VERTEX_INPUT_RATE_VERTEX },
+        } };
+        static constexpr std::array<VkVertexInputAttributeDescription, 2> attributes{ {
+            { 0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(VtModel::Vertex, position) },
+            { 1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(VtModel::Vertex, colour) },
+        } };
+    };
+
+    template <>
+    struct VtVertexInputTraits<VtModel::Instance> {
+        static constexpr std::array<VkVertexInputBindingDescription, 1> bindings{ {
+            { 1, sizeof(VtModel::Instance), VK_VERTEX_INPUT_RATE_INSTANCE },
+        } };
+        static constexpr std::array<VkVertexInputAttributeDescription, 2> attributes{ {
+            { 2, 1, VK_FORMAT_R32G32_SFLOAT, offsetof(VtModel::Instance, offset) },
+            { 3, 1, VK_FORMAT_R32G32B32_SFLOAT, offsetof(VtModel::Instance, colour) },
+        } };
     };
 }
\ No newline at end of file
@@ -0,0 +1,251 @@
+#include "vt_offscreen_target.h"
+
+//std
+#include <array>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+namespace vt {
+
+    VtOffscreenTarget::VtOffscreenTarget(VtDevice& _device, VkExtent2D _extent, const VtFrameSettings& _settings)
+        : vtDevice{ _device }, extent{ _extent }, images(_settings.imageCount == 0 ? _settings.framesInFlight + 1 : _settings.imageCount),
+        frameValues(_settings.framesInFlight, 0) {
+        if (_settings.useTimelineSemaphores) {
+            timeline = vtDevice.graphicsTimeline();
+            if (timeline == nullptr) {
+                std::cout << "Timeline semaphores unsupported, falling back to fences" << std::endl;
+            }
+        }
+
+        depthFormat = vtDevice.findSupportedFormat(
+            { VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT },
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
+
+        createRenderPass();
+        depthAttachments = std::make_unique<VtDepthAttachments>(
+            vtDevice, extent, depthFormat, _settings.framesInFlight, _settings.useTransientDepth);
+        createImages();
+        createSyncObjects();
+    }
+
+    VtOffscreenTarget::~VtOffscreenTarget() {
+        for (auto& image : images) {
+            for (auto framebuffer : image.framebuffers) {
+                vkDestroyFramebuffer(vtDevice.device(), framebuffer, nullptr);
+            }
+            vkDestroyImageView(vtDevice.device(), image.colorView, nullptr);
+            vtDevice.destroyImage(image.color, image.colorMemory);
+        }
+        depthAttachments.reset();
+
+        for (auto fence : inFlightFences) {
+            vkDestroyFence(vtDevice.device(), fence, nullptr);
+        }
+
+        vkDestroyRenderPass(vtDevice.device(), renderPass, nullptr);
+    }
+
+    VkResult VtOffscreenTarget::acquireNextImage(uint32_t* _imageIndex) {
+        if (timeline != nullptr) {
+            timeline->wait(frameValues[currentFrame]);
+        }
+        else {
+            vkWaitForFences(vtDevice.device(), 1, &inFlightFences[currentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max());
+        }
+        markRetired(currentFrame);
+
+        // There is no presentation engine handing images back, so simply walk the ring.
+        *_imageIndex = nextImage;
+        nextImage = (nextImage + 1) % static_cast<uint32_t>(images.size());
+        return VK_SUCCESS;
+    }
+
+    VkResult VtOffscreenTarget::submitCommandBuffers(const VkCommandBuffer* _buffers, uint32_t* _imageIndex) {
+        Image& image = images[*_imageIndex];
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = _buffers;
+
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        VkSemaphore timelineSemaphore = VK_NULL_HANDLE;
+        uint64_t signalValue = 0;
+        VkFence fence = VK_NULL_HANDLE;
+        if (timeline != nullptr) {
+            timeline->wait(image.retireValue);
+            timelineSemaphore = timeline->handle();
+            signalValue = timeline->advance();
+
+            timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+            timelineInfo.signalSemaphoreValueCount = 1;
+            timelineInfo.pSignalSemaphoreValues = &signalValue;
+            submitInfo.pNext = &timelineInfo;
+            submitInfo.signalSemaphoreCount = 1;
+            submitInfo.pSignalSemaphores = &timelineSemaphore;
+
+            frameValues[currentFrame] = signalValue;
+            image.retireValue = signalValue;
+        }
+        else {
+            if (image.inFlight != VK_NULL_HANDLE) {
+                vkWaitForFences(vtDevice.device(), 1, &image.inFlight, VK_TRUE, std::numeric_limits<uint64_t>::max());
+            }
+            fence = inFlightFences[currentFrame];
+            image.inFlight = fence;
+            vkResetFences(vtDevice.device(), 1, &fence);
+        }
+
+        VkResult submitResult;
+        {
+            std::lock_guard<std::mutex> lock{ vtDevice.queueMutex(vtDevice.graphicsQueue()) };
+            submitResult = vkQueueSubmit(vtDevice.graphicsQueue(), 1, &submitInfo, fence);
+        }
+        if (submitResult != VK_SUCCESS) {
+            throw std::runtime_error("failed to submit draw command buffer!");
+        }
+        markSubmitted(currentFrame);
+
+        currentFrame = (currentFrame + 1) % framesInFlight();
+        return VK_SUCCESS;
+    }
+
+    void VtOffscreenTarget::createRenderPass() {
+        VkAttachmentDescription colorAttachment{};
+        colorAttachment.format = COLOR_FORMAT;
+        colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+        VkAttachmentDescription depthAttachment{};
+        depthAttachment.format = depthFormat;
+        depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        VkAttachmentReference colorAttachmentRef{};
+        colorAttachmentRef.attachment = 0;
+        colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkAttachmentReference depthAttachmentRef{};
+        depthAttachmentRef.attachment = 1;
+        depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription subpass{};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = 1;
+        subpass.pColorAttachments = &colorAttachmentRef;
+        subpass.pDepthStencilAttachment = &depthAttachmentRef;
+
+        // Same external dependency as the swap chain pass, so pipelines built for either are interchangeable.
+        VkSubpassDependency dependency{};
+        dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependency.srcAccessMask = 0;
+        dependency.srcStageMask =
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        dependency.dstSubpass = 0;
+        dependency.dstStageMask =
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        dependency.dstAccessMask =
+            VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+        std::array<VkAttachmentDescription, 2> attachments = { colorAttachment, depthAttachment };
+        VkRenderPassCreateInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+        renderPassInfo.pAttachments = attachments.data();
+        renderPassInfo.subpassCount = 1;
+        renderPassInfo.pSubpasses = &subpass;
+        renderPassInfo.dependencyCount = 1;
+        renderPassInfo.pDependencies = &dependency;
+
+        if (vkCreateRenderPass(vtDevice.device(), &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create render pass!");
+        }
+    }
+
+    void VtOffscreenTarget::createImages() {
+        for (auto& image : images) {
+            VkImageCreateInfo imageInfo{};
+            imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            imageInfo.imageType = VK_IMAGE_TYPE_2D;
+            imageInfo.extent.width = extent.width;
+            imageInfo.extent.height = extent.height;
+            imageInfo.extent.depth = 1;
+            imageInfo.mipLevels = 1;
+            imageInfo.arrayLayers = 1;
+            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+            imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+            imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+            imageInfo.format = COLOR_FORMAT;
+            imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+            vtDevice.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image.color, image.colorMemory);
+            image.colorView = createImageView(image.color, COLOR_FORMAT, VK_IMAGE_ASPECT_COLOR_BIT);
+
+            image.framebuffers.resize(depthAttachments->count());
+            for (uint32_t frame = 0; frame < depthAttachments->count(); frame++) {
+                std::array<VkImageView, 2> attachments = { image.colorView, depthAttachments->getView(frame) };
+                VkFramebufferCreateInfo framebufferInfo{};
+                framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+                framebufferInfo.renderPass = renderPass;
+                framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+                framebufferInfo.pAttachments = attachments.data();
+                framebufferInfo.width = extent.width;
+                framebufferInfo.height = extent.height;
+                framebufferInfo.layers = 1;
+
+                if (vkCreateFramebuffer(vtDevice.device(), &framebufferInfo, nullptr, &image.framebuffers[frame]) != VK_SUCCESS) {
+                    throw std::runtime_error("failed to create framebuffer!");
+                }
+            }
+        }
+    }
+
+    void VtOffscreenTarget::createSyncObjects() {
+        if (timeline != nullptr) {
+            return;
+        }
+        inFlightFences.resize(frameValues.size());
+
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+        for (auto& fence : inFlightFences) {
+            if (vkCreateFence(vtDevice.device(), &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create synchronization objects for a frame!");
+            }
+        }
+    }
+
+    VkImageView VtOffscreenTarget::createImageView(VkImage _image, VkFormat _format, VkImageAspectFlags _aspect) {
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = _image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = _format;
+        viewInfo.subresourceRange.aspectMask = _aspect;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+
+        VkImageView view;
+        if (vkCreateImageView(vtDevice.device(), &viewInfo, nullptr, &view) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create image view!");
+        }
+        return view;
+    }
+}
\ No newline at end of file
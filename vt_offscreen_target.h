@@ -0,0 +1,73 @@
+#pragma once
+
+#include "vt_depth_attachments.h"
+#include "vt_device.h"
+#include "vt_render_target.h"
+
+//vulkan
+#include <vulkan/vulkan.h>
+
+//std
+#include <memory>
+#include <vector>
+
+namespace vt {
+
+    // Renders into a ring of device-local colour images instead of a swap chain, so the
+    // engine can run with no window or surface (CI, benchmark boxes, software ICDs like lavapipe).
+    // Frames in flight are paced by fences exactly like VtSwapChain; nothing is ever presented.
+    class VtOffscreenTarget : public VtRenderTarget {
+    public:
+        static constexpr VkFormat COLOR_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+
+        // The present mode in _settings is ignored, there is nothing to present to.
+        VtOffscreenTarget(VtDevice& _device, VkExtent2D _extent, const VtFrameSettings& _settings = {});
+        ~VtOffscreenTarget() override;
+
+        VtOffscreenTarget(const VtOffscreenTarget&) = delete;
+        VtOffscreenTarget& operator=(const VtOffscreenTarget&) = delete;
+
+        VkFramebuffer getFrameBuffer(int _index) override { return images[_index].framebuffers[currentFrame]; }
+        VkRenderPass getRenderPass() override { return renderPass; }
+        size_t imageCount() override { return images.size(); }
+        VkExtent2D getExtent() override { return extent; }
+        uint32_t getCurrentFrame() override { return currentFrame; }
+        uint32_t framesInFlight() override { return static_cast<uint32_t>(frameValues.size()); }
+
+        // Colour images are left in TRANSFER_SRC_OPTIMAL after the render pass, ready to be read back.
+        VkImage getColorImage(int _index) { return images[_index].color; }
+
+        VkResult acquireNextImage(uint32_t* _imageIndex) override;
+        VkResult submitCommandBuffers(const VkCommandBuffer* _buffers, uint32_t* _imageIndex) override;
+
+    private:
+        struct Image {
+            VkImage color = VK_NULL_HANDLE;
+            VtAllocation colorMemory{};
+            VkImageView colorView = VK_NULL_HANDLE;
+            // One per frame in flight, each with that frame's depth attachment.
+            std::vector<VkFramebuffer> framebuffers;
+            VkFence inFlight = VK_NULL_HANDLE;
+            uint64_t retireValue = 0;
+        };
+
+        void createRenderPass();
+        void createImages();
+        void createSyncObjects();
+        VkImageView createImageView(VkImage _image, VkFormat _format, VkImageAspectFlags _aspect);
+
+        VtDevice& vtDevice;
+        VkExtent2D extent;
+        VkFormat depthFormat;
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        std::unique_ptr<VtDepthAttachments> depthAttachments;
+
+        std::vector<Image> images;
+        std::vector<VkFence> inFlightFences;
+        // Timeline mode replaces the fences with the device's graphics timeline.
+        VtTimeline* timeline = nullptr;
+        std::vector<uint64_t> frameValues;
+        uint32_t currentFrame = 0;
+        uint32_t nextImage = 0;
+    };
+}
\ No newline at end of file
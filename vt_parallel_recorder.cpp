@@ -0,0 +1,166 @@
+#include "vt_parallel_recorder.h"
+
+//std
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace vt {
+
+    VtParallelRecorder::VtParallelRecorder(VtDevice& _device, uint32_t _frameCount, uint32_t _workerCount) : vtDevice{ _device } {
+        if (_workerCount == 0) {
+            _workerCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        workers.resize(_workerCount);
+        for (auto& worker : workers) {
+            worker.commandPools.resize(_frameCount);
+            worker.commandBuffers.resize(_frameCount);
+
+            for (uint32_t frame = 0; frame < _frameCount; frame++) {
+                VkCommandPoolCreateInfo poolInfo{};
+                poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+                poolInfo.queueFamilyIndex = vtDevice.findPhysicalQueueFamilies().graphicsFamily;
+                poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+                if (vkCreateCommandPool(vtDevice.device(), &poolInfo, nullptr, &worker.commandPools[frame]) != VK_SUCCESS) {
+                    throw std::runtime_error("failed to create worker command pool!");
+                }
+
+                VkCommandBufferAllocateInfo allocateInfo{};
+                allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+                allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+                allocateInfo.commandPool = worker.commandPools[frame];
+                allocateInfo.commandBufferCount = 1;
+
+                if (vkAllocateCommandBuffers(vtDevice.device(), &allocateInfo, &worker.commandBuffers[frame]) != VK_SUCCESS) {
+                    throw std::runtime_error("failed to allocate secondary command buffer!");
+                }
+            }
+        }
+
+        // The calling thread records the first share itself, so only the remaining workers get a thread.
+        for (uint32_t i = 1; i < workers.size(); i++) {
+            workers[i].thread = std::thread{ &VtParallelRecorder::workerLoop, this, i };
+        }
+    }
+
+    VtParallelRecorder::~VtParallelRecorder() {
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            stopping = true;
+        }
+        workAvailable.notify_all();
+
+        for (auto& worker : workers) {
+            if (worker.thread.joinable()) {
+                worker.thread.join();
+            }
+            for (auto commandPool : worker.commandPools) {
+                vkDestroyCommandPool(vtDevice.device(), commandPool, nullptr);
+            }
+        }
+    }
+
+    const std::vector<VkCommandBuffer>& VtParallelRecorder::record(
+        uint32_t _frameIndex,
+        const VkCommandBufferInheritanceInfo& _inheritance,
+        uint32_t _drawCount,
+        const RecordRange& _recordRange) {
+        assert(_frameIndex < workers[0].commandPools.size() && "Frame index out of range");
+
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            frameIndex = _frameIndex;
+            drawCount = _drawCount;
+            inheritance = &_inheritance;
+            recordRange = &_recordRange;
+            failure = nullptr;
+            pendingWorkers = static_cast<uint32_t>(workers.size()) - 1;
+            generation++;
+        }
+        workAvailable.notify_all();
+
+        try {
+            recordShare(0);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock{ mutex };
+            failure = std::current_exception();
+        }
+
+        {
+            std::unique_lock<std::mutex> lock{ mutex };
+            workFinished.wait(lock, [this] { return pendingWorkers == 0; });
+            if (failure) {
+                std::rethrow_exception(failure);
+            }
+        }
+
+        // Workers that were handed an empty range recorded nothing and are left out.
+        recorded.clear();
+        uint32_t drawsPerWorker = (_drawCount + workerCount() - 1) / workerCount();
+        for (uint32_t i = 0; i < workers.size() && i * drawsPerWorker < _drawCount; i++) {
+            recorded.push_back(workers[i].commandBuffers[_frameIndex]);
+        }
+        return recorded;
+    }
+
+    void VtParallelRecorder::workerLoop(uint32_t _workerIndex) {
+        uint64_t seenGeneration = 0;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock{ mutex };
+                workAvailable.wait(lock, [&] { return stopping || generation != seenGeneration; });
+                if (stopping) {
+                    return;
+                }
+                seenGeneration = generation;
+            }
+
+            try {
+                recordShare(_workerIndex);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock{ mutex };
+                failure = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{ mutex };
+                pendingWorkers--;
+            }
+            workFinished.notify_one();
+        }
+    }
+
+    void VtParallelRecorder::recordShare(uint32_t _workerIndex) {
+        // Contiguous ranges keep each worker's draws in submission order when the buffers are executed back to back.
+        uint32_t drawsPerWorker = (drawCount + workerCount() - 1) / workerCount();
+        uint32_t begin = std::min(drawCount, _workerIndex * drawsPerWorker);
+        uint32_t end = std::min(drawCount, begin + drawsPerWorker);
+        if (begin == end) {
+            return;
+        }
+
+        Worker& worker = workers[_workerIndex];
+        vkResetCommandPool(vtDevice.device(), worker.commandPools[frameIndex], 0);
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        beginInfo.pInheritanceInfo = inheritance;
+
+        VkCommandBuffer commandBuffer = worker.commandBuffers[frameIndex];
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to begin recording secondary command buffer!");
+        }
+
+        (*recordRange)(commandBuffer, begin, end);
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to record secondary command buffer!");
+        }
+    }
+}
\ No newline at end of file
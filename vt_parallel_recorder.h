@@ -0,0 +1,69 @@
+#pragma once
+
+#include "vt_device.h"
+
+//std
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vt {
+
+    // Splits a frame's draw list across worker threads. Each worker records its share into a secondary
+    // command buffer that continues the caller's render pass; the caller executes them all from its
+    // primary buffer with vkCmdExecuteCommands.
+    class VtParallelRecorder {
+    public:
+        // Records draws [_begin, _end) into a secondary buffer that is already inside the render pass.
+        using RecordRange = std::function<void(VkCommandBuffer _commandBuffer, uint32_t _begin, uint32_t _end)>;
+
+        // _workerCount of 0 uses one worker per hardware thread.
+        VtParallelRecorder(VtDevice& _device, uint32_t _frameCount, uint32_t _workerCount = 0);
+        ~VtParallelRecorder();
+
+        VtParallelRecorder(const VtParallelRecorder&) = delete;
+        VtParallelRecorder& operator=(const VtParallelRecorder&) = delete;
+
+        // Only call once the frame's fence has signalled, as the frame's pools are reset here.
+        // Returns the recorded secondary buffers in draw order.
+        const std::vector<VkCommandBuffer>& record(
+            uint32_t _frameIndex,
+            const VkCommandBufferInheritanceInfo& _inheritance,
+            uint32_t _drawCount,
+            const RecordRange& _recordRange);
+
+        uint32_t workerCount() const { return static_cast<uint32_t>(workers.size()); }
+
+    private:
+        // Command pools are externally synchronized, so every worker gets its own pool per frame in flight.
+        struct Worker {
+            std::vector<VkCommandPool> commandPools;
+            std::vector<VkCommandBuffer> commandBuffers;
+            std::thread thread;
+        };
+
+        void workerLoop(uint32_t _workerIndex);
+        void recordShare(uint32_t _workerIndex);
+
+        VtDevice& vtDevice;
+        std::vector<Worker> workers;
+        std::vector<VkCommandBuffer> recorded;
+
+        // The job currently being recorded, published to the workers under mutex.
+        uint32_t frameIndex = 0;
+        uint32_t drawCount = 0;
+        const VkCommandBufferInheritanceInfo* inheritance = nullptr;
+        const RecordRange* recordRange = nullptr;
+
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable workFinished;
+        uint64_t generation = 0;
+        uint32_t pendingWorkers = 0;
+        bool stopping = false;
+        std::exception_ptr failure;
+    };
+}
\ No newline at end of file
@@ -1,12 +1,14 @@
 #include "vt_pipeline.h"
 
-#include "vt_model.h"
-
 //std
+#include <algorithm>
 #include <fstream>
 #include <stdexcept>
 #include <iostream>
 #include <cassert>
+#include <chrono>
+#include <cstring>
+#include <functional>
 
 namespace vt {
 
@@ -44,15 +46,27 @@ namespace vt {
 
     void VtPipeline::createGraphicsPipeline(const std::string& _vertFilePath, const std::string& _fragFilepath, const PipelineConfigInfo& _configInfo) {
 
-        assert(_configInfo.pipelineLayout != VK_NULL_HANDLE && "Cannot create graphics pipeline:: no pipelineLayout Provided in configInfo");
         assert(_configInfo.renderPass != VK_NULL_HANDLE && "Cannot create graphics pipeline:: no renderPass in configInfo");
 
         auto vertCode = readFile(_vertFilePath);
         auto fragCode = readFile(_fragFilepath);
 
+        VtShaderReflection vertReflection{ vertCode };
+        VtShaderReflection fragReflection{ fragCode };
+        checkSpecialization(vertReflection, _configInfo.vertexSpecialization, _vertFilePath);
+        checkSpecialization(fragReflection, _configInfo.fragmentSpecialization, _fragFilepath);
+
+        reflection = std::move(vertReflection);
+        reflection.merge(fragReflection);
+        checkVertexInput(_configInfo.vertexInput);
+        pipelineLayout = _configInfo.pipelineLayout != VK_NULL_HANDLE ? _configInfo.pipelineLayout : vtDevice.layoutCache().getPipelineLayout(reflection);
+
         createShaderModule(vertCode, &vertShaderModule);
         createShaderModule(fragCode, &fragShaderModule);
 
+        VkSpecializationInfo vertSpecializationInfo = _configInfo.vertexSpecialization.getInfo();
+        VkSpecializationInfo fragSpecializationInfo = _configInfo.fragmentSpecialization.getInfo();
+
         VkPipelineShaderStageCreateInfo shaderStages[2];
 
         shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -61,7 +75,7 @@ namespace vt {
         shaderStages[0].pName = "main";
         shaderStages[0].flags = 0;
         shaderStages[0].pNext = nullptr;
-        shaderStages[0].pSpecializationInfo = nullptr;
+        shaderStages[0].pSpecializationInfo = _configInfo.vertexSpecialization.empty() ? nullptr : &vertSpecializationInfo;
 
         shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
@@ -69,16 +83,15 @@ namespace vt {
         shaderStages[1].pName = "main";
         shaderStages[1].flags = 0;
         shaderStages[1].pNext = nullptr;
-        shaderStages[1].pSpecializationInfo = nullptr;
+        shaderStages[1].pSpecializationInfo = _configInfo.fragmentSpecialization.empty() ? nullptr : &fragSpecializationInfo;
 
-        auto bindingDescriptions = VtModel::Vertex::getBindingDescriptions();
-        auto attributeDescriptions = VtModel::Vertex::getAttributeDescriptions();
+        auto& vertexInput = _configInfo.vertexInput;
         VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
         vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-        vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(bindingDescriptions.size());
-        vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
-        vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions.data();
+        vertexInputInfo.vertexAttributeDescriptionCount = vertexInput.attributeCount;
+        vertexInputInfo.vertexBindingDescriptionCount = vertexInput.bindingCount;
+        vertexInputInfo.pVertexAttributeDescriptions = vertexInput.attributes.data();
+        vertexInputInfo.pVertexBindingDescriptions = vertexInput.bindings.data();
 
         VkGraphicsPipelineCreateInfo pipelineInfo{};
         pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -93,16 +106,40 @@ namespace vt {
         pipelineInfo.pDepthStencilState = &_configInfo.depthStencilInfo;
         pipelineInfo.pDynamicState = &_configInfo.dynamicStateInfo;
 
-        pipelineInfo.layout = _configInfo.pipelineLayout;
+        pipelineInfo.layout = pipelineLayout;
         pipelineInfo.renderPass = _configInfo.renderPass;
         pipelineInfo.subpass = _configInfo.subpass;
 
         pipelineInfo.basePipelineIndex = -1;
         pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-        if (vkCreateGraphicsPipelines(vtDevice.device(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS) {
+        auto start = std::chrono::steady_clock::now();
+        if (vkCreateGraphicsPipelines(vtDevice.device(), vtDevice.pipelineCache().handle(), 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create graphics pipeline");
         }
+        vtDevice.pipelineCache().recordCreation(std::chrono::steady_clock::now() - start);
+    }
+
+    void VtPipeline::checkVertexInput(const VtVertexInput& _vertexInput) {
+        for (const auto& input : reflection.getVertexInputs()) {
+            bool described = false;
+            for (uint32_t i = 0; i < _vertexInput.attributeCount; i++) {
+                described |= _vertexInput.attributes[i].location == input.location;
+            }
+            if (!described) {
+                throw std::runtime_error("Vertex shader input at location " + std::to_string(input.location) + " has no vertex attribute");
+            }
+        }
+    }
+
+    void VtPipeline::checkSpecialization(const VtShaderReflection& _stage, const VtSpecializationConstants& _constants, const std::string& _filepath) {
+        const auto& declared = _stage.getSpecializationConstants();
+        for (uint32_t i = 0; i < _constants.count; i++) {
+            uint32_t constantId = _constants.entries[i].constantID;
+            if (!std::binary_search(declared.begin(), declared.end(), constantId)) {
+                throw std::runtime_error("Shader declares no specialization constant " + std::to_string(constantId) + ": " + _filepath);
+            }
+        }
     }
 
     void VtPipeline::createShaderModule(const std::vector<char>& _code, VkShaderModule* _shaderModule) {
@@ -123,6 +160,10 @@ namespace vt {
 
     void VtPipeline::defaultPipelineConfigInfo(PipelineConfigInfo& _configInfo) {
 
+        _configInfo.vertexInput = VtVertexInput{};
+        _configInfo.vertexSpecialization = VtSpecializationConstants{};
+        _configInfo.fragmentSpecialization = VtSpecializationConstants{};
+
         _configInfo.inputAssemblyInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
         _configInfo.inputAssemblyInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
         _configInfo.inputAssemblyInfo.primitiveRestartEnable = VK_FALSE;
@@ -190,4 +231,87 @@ namespace vt {
         _configInfo.dynamicStateInfo.dynamicStateCount = static_cast<uint32_t>(_configInfo.dynamicStateEnables.size());
         _configInfo.dynamicStateInfo.flags = 0;
     }
+
+    size_t VtPipeline::hashConfigInfo(const PipelineConfigInfo& _configInfo) {
+        size_t seed = 0;
+        auto combine = [&seed](uint64_t _value) {
+            seed ^= std::hash<uint64_t>{}(_value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        };
+        auto combineFloat = [&combine](float _value) {
+            uint32_t bits;
+            memcpy(&bits, &_value, sizeof(bits));
+            combine(bits);
+        };
+
+        const VtVertexInput& vertexInput = _configInfo.vertexInput;
+        combine(vertexInput.bindingCount);
+        for (uint32_t i = 0; i < vertexInput.bindingCount; i++) {
+            combine(vertexInput.bindings[i].binding);
+            combine(vertexInput.bindings[i].stride);
+            combine(vertexInput.bindings[i].inputRate);
+        }
+        combine(vertexInput.attributeCount);
+        for (uint32_t i = 0; i < vertexInput.attributeCount; i++) {
+            combine(vertexInput.attributes[i].location);
+            combine(vertexInput.attributes[i].binding);
+            combine(vertexInput.attributes[i].format);
+            combine(vertexInput.attributes[i].offset);
+        }
+
+        combine(_configInfo.inputAssemblyInfo.topology);
+        combine(_configInfo.inputAssemblyInfo.primitiveRestartEnable);
+
+        const VkPipelineRasterizationStateCreateInfo& rasterization = _configInfo.rasterizationInfo;
+        combine(rasterization.depthClampEnable);
+        combine(rasterization.rasterizerDiscardEnable);
+        combine(rasterization.polygonMode);
+        combine(rasterization.cullMode);
+        combine(rasterization.frontFace);
+        combine(rasterization.depthBiasEnable);
+        combineFloat(rasterization.depthBiasConstantFactor);
+        combineFloat(rasterization.depthBiasClamp);
+        combineFloat(rasterization.depthBiasSlopeFactor);
+        combineFloat(rasterization.lineWidth);
+
+        combine(_configInfo.multisampleInfo.rasterizationSamples);
+        combine(_configInfo.multisampleInfo.sampleShadingEnable);
+        combineFloat(_configInfo.multisampleInfo.minSampleShading);
+        combine(_configInfo.multisampleInfo.alphaToCoverageEnable);
+        combine(_configInfo.multisampleInfo.alphaToOneEnable);
+
+        const VkPipelineColorBlendAttachmentState& blend = _configInfo.colorBlendAttachment;
+        combine(blend.blendEnable);
+        combine(blend.srcColorBlendFactor);
+        combine(blend.dstColorBlendFactor);
+        combine(blend.colorBlendOp);
+        combine(blend.srcAlphaBlendFactor);
+        combine(blend.dstAlphaBlendFactor);
+        combine(blend.alphaBlendOp);
+        combine(blend.colorWriteMask);
+        combine(_configInfo.colorBlendInfo.logicOpEnable);
+        combine(_configInfo.colorBlendInfo.logicOp);
+        for (float constant : _configInfo.colorBlendInfo.blendConstants) {
+            combineFloat(constant);
+        }
+
+        const VkPipelineDepthStencilStateCreateInfo& depthStencil = _configInfo.depthStencilInfo;
+        combine(depthStencil.depthTestEnable);
+        combine(depthStencil.depthWriteEnable);
+        combine(depthStencil.depthCompareOp);
+        combine(depthStencil.depthBoundsTestEnable);
+        combineFloat(depthStencil.minDepthBounds);
+        combineFloat(depthStencil.maxDepthBounds);
+        combine(depthStencil.stencilTestEnable);
+
+        combine(_configInfo.dynamicStateInfo.dynamicStateCount);
+        for (uint32_t i = 0; i < _configInfo.dynamicStateInfo.dynamicStateCount; i++) {
+            combine(_configInfo.dynamicStateInfo.pDynamicStates[i]);
+        }
+
+        // Handles are pointers on 64-bit targets and integers on 32-bit ones; std::hash takes either.
+        combine(std::hash<VkPipelineLayout>{}(_configInfo.pipelineLayout));
+        combine(std::hash<VkRenderPass>{}(_configInfo.renderPass));
+        combine(_configInfo.subpass);
+        return seed;
+    }
 }
\ No newline at end of file
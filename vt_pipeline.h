@@ -1,8 +1,12 @@
 #pragma once
 
 #include "vt_device.h"
+#include "vt_shader_reflection.h"
+#include "vt_specialization.h"
+#include "vt_vertex_input.h"
 
 //std
+#include <array>
 #include <string>
 #include <vector>
 
@@ -15,6 +19,11 @@ namespace vt {
         PipelineConfigInfo(const PipelineConfigInfo&) = delete;
         PipelineConfigInfo& operator=(const PipelineConfigInfo&) = delete;
 
+        // Filled from VtVertexInputTraits, e.g. vertexInputOf<VtModel::Vertex>, so any vertex type works.
+        VtVertexInput vertexInput{};
+        // Values for each stage's specialization constants; every constant_id set must be declared by that stage.
+        VtSpecializationConstants vertexSpecialization{};
+        VtSpecializationConstants fragmentSpecialization{};
         VkPipelineViewportStateCreateInfo viewportInfo;
         VkPipelineInputAssemblyStateCreateInfo inputAssemblyInfo;
         VkPipelineRasterizationStateCreateInfo rasterizationInfo;
@@ -22,8 +31,9 @@ namespace vt {
         VkPipelineColorBlendAttachmentState colorBlendAttachment;
         VkPipelineColorBlendStateCreateInfo colorBlendInfo;
         VkPipelineDepthStencilStateCreateInfo depthStencilInfo;
-        std::vector<VkDynamicState> dynamicStateEnables;
+        std::array<VkDynamicState, 2> dynamicStateEnables;
         VkPipelineDynamicStateCreateInfo dynamicStateInfo;
+        // Left null, the layout is reflected from the shaders and shared through the device's VtLayoutCache.
         VkPipelineLayout pipelineLayout = nullptr;
         VkRenderPass renderPass = nullptr;
         uint32_t subpass = 0;
@@ -44,16 +54,33 @@ namespace vt {
 
         void bind(VkCommandBuffer _commandBuffer);
 
+        VkPipelineLayout getLayout() const { return pipelineLayout; }
+        // Both stages' interface, merged.
+        const VtShaderReflection& getReflection() const { return reflection; }
+
+        // Leaves vertexInput empty, for callers to describe the vertex streams they draw.
         static void defaultPipelineConfigInfo(PipelineConfigInfo& _configInfo);
 
-    private:
         static std::vector<char> readFile(const std::string& _filepath);
 
+        // Hash of everything in _configInfo but the specialization constants: vertex input, fixed function
+        // state, layout and render pass.
+        static size_t hashConfigInfo(const PipelineConfigInfo& _configInfo);
+
+    private:
+
         void createGraphicsPipeline(const std::string& _vertFilePath, const std::string& _fragFilepath, const PipelineConfigInfo& _configInfo);
 
+        // Throws when _constants sets a constant_id the stage does not declare.
+        static void checkSpecialization(const VtShaderReflection& _stage, const VtSpecializationConstants& _constants, const std::string& _filepath);
+        // Throws when the vertex shader reads a location _vertexInput does not feed.
+        void checkVertexInput(const VtVertexInput& _vertexInput);
+
         void createShaderModule(const std::vector<char>& _code, VkShaderModule* _shaderModule);
 
         VtDevice& vtDevice;
+        VtShaderReflection reflection;
+        VkPipelineLayout pipelineLayout;
         VkPipeline graphicsPipeline;
         VkShaderModule vertShaderModule;
         VkShaderModule fragShaderModule;
@@ -0,0 +1,139 @@
+#include "vt_pipeline_cache.h"
+
+//std
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace vt {
+
+    // Layout of the version one header every implementation writes at the start of its cache data.
+    static constexpr size_t HEADER_SIZE_OFFSET = 0;
+    static constexpr size_t HEADER_VERSION_OFFSET = 4;
+    static constexpr size_t VENDOR_ID_OFFSET = 8;
+    static constexpr size_t DEVICE_ID_OFFSET = 12;
+    static constexpr size_t CACHE_UUID_OFFSET = 16;
+    static constexpr size_t MIN_HEADER_SIZE = CACHE_UUID_OFFSET + VK_UUID_SIZE;
+
+    static uint32_t readU32(const std::vector<char>& _data, size_t _offset) {
+        uint32_t value;
+        std::memcpy(&value, _data.data() + _offset, sizeof(value));
+        return value;
+    }
+
+    VtPipelineCache::VtPipelineCache(VkDevice _device, const VkPhysicalDeviceProperties& _properties, const std::string& _filepath)
+        : device{ _device }, properties{ _properties }, filepath{ _filepath } {
+        std::vector<char> initialData = loadValidated();
+        warm = !initialData.empty();
+
+        VkPipelineCacheCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.initialDataSize = initialData.size();
+        createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+        if (vkCreatePipelineCache(device, &createInfo, nullptr, &cache) != VK_SUCCESS) {
+            // The header matched but the driver still refused the payload; start again from nothing.
+            createInfo.initialDataSize = 0;
+            createInfo.pInitialData = nullptr;
+            warm = false;
+
+            if (vkCreatePipelineCache(device, &createInfo, nullptr, &cache) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create pipeline cache!");
+            }
+        }
+    }
+
+    VtPipelineCache::~VtPipelineCache() {
+        try {
+            save();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "failed to save pipeline cache: " << e.what() << std::endl;
+        }
+        vkDestroyPipelineCache(device, cache, nullptr);
+    }
+
+    void VtPipelineCache::save() {
+        size_t dataSize = 0;
+        if (vkGetPipelineCacheData(device, cache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0) {
+            return;
+        }
+
+        std::vector<char> data(dataSize);
+        if (vkGetPipelineCacheData(device, cache, &dataSize, data.data()) != VK_SUCCESS) {
+            throw std::runtime_error("failed to read pipeline cache data!");
+        }
+        data.resize(dataSize);
+
+        // Write beside the real file and swap it in, so a crash mid-write never leaves a truncated cache.
+        std::string tempPath = filepath + ".tmp";
+        {
+            std::ofstream file{ tempPath, std::ios::binary | std::ios::trunc };
+            if (!file.is_open()) {
+                throw std::runtime_error("Failed to open file: " + tempPath);
+            }
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!file) {
+                throw std::runtime_error("Failed to write file: " + tempPath);
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, filepath, error);
+        if (error) {
+            std::filesystem::remove(tempPath, error);
+            throw std::runtime_error("Failed to replace file: " + filepath);
+        }
+    }
+
+    void VtPipelineCache::recordCreation(std::chrono::duration<double, std::milli> _elapsed) {
+        std::lock_guard<std::mutex> lock{ statsMutex };
+        pipelineCount++;
+        creationMilliseconds += _elapsed.count();
+    }
+
+    void VtPipelineCache::reportCreationTime() {
+        std::lock_guard<std::mutex> lock{ statsMutex };
+        std::cout << "pipeline creation (" << (warm ? "warm" : "cold") << " cache): "
+            << pipelineCount << " pipelines in " << creationMilliseconds << " ms" << std::endl;
+    }
+
+    std::vector<char> VtPipelineCache::loadValidated() {
+        std::ifstream file{ filepath, std::ios::ate | std::ios::binary };
+        if (!file.is_open()) {
+            return {};
+        }
+
+        std::vector<char> data(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!file) {
+            return {};
+        }
+
+        if (!isCompatible(data)) {
+            std::cout << "discarding stale pipeline cache: " << filepath << std::endl;
+            return {};
+        }
+        return data;
+    }
+
+    bool VtPipelineCache::isCompatible(const std::vector<char>& _data) {
+        // Drivers must reject foreign data themselves, but some crash instead, so check the header before handing it over.
+        if (_data.size() < MIN_HEADER_SIZE) {
+            return false;
+        }
+
+        uint32_t headerSize = readU32(_data, HEADER_SIZE_OFFSET);
+        if (headerSize < MIN_HEADER_SIZE || headerSize > _data.size()) {
+            return false;
+        }
+
+        return readU32(_data, HEADER_VERSION_OFFSET) == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+            readU32(_data, VENDOR_ID_OFFSET) == properties.vendorID &&
+            readU32(_data, DEVICE_ID_OFFSET) == properties.deviceID &&
+            std::memcmp(_data.data() + CACHE_UUID_OFFSET, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+//vulkan
+#include <vulkan/vulkan.h>
+
+//std
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace vt {
+
+    // Owns the device's VkPipelineCache. Seeds it from disk on construction and writes it back on
+    // destruction, so drivers can skip shader compilation for pipelines built on a previous run.
+    class VtPipelineCache {
+    public:
+        VtPipelineCache(VkDevice _device, const VkPhysicalDeviceProperties& _properties, const std::string& _filepath);
+        ~VtPipelineCache();
+
+        VtPipelineCache(const VtPipelineCache&) = delete;
+        VtPipelineCache& operator=(const VtPipelineCache&) = delete;
+
+        VkPipelineCache handle() { return cache; }
+
+        // True when the cache was seeded from a file written by this exact device and driver.
+        bool isWarm() const { return warm; }
+
+        void save();
+
+        // Accumulates time spent in vkCreate*Pipelines so warm and cold startups can be compared.
+        void recordCreation(std::chrono::duration<double, std::milli> _elapsed);
+        void reportCreationTime();
+
+    private:
+        std::vector<char> loadValidated();
+        bool isCompatible(const std::vector<char>& _data);
+
+        VkDevice device;
+        VkPhysicalDeviceProperties properties;
+        std::string filepath;
+        VkPipelineCache cache = VK_NULL_HANDLE;
+        bool warm = false;
+
+        std::mutex statsMutex;
+        uint32_t pipelineCount = 0;
+        double creationMilliseconds = 0.0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "vt_pipeline_manager.h"
+
+//std
+#include <algorithm>
+#include <cassert>
+
+namespace vt {
+
+    namespace {
+
+        void appendSpecialization(std::vector<uint64_t>& _key, const VtSpecializationConstants& _constants) {
+            size_t first = _key.size();
+            _key.push_back(_constants.count);
+            for (uint32_t i = 0; i < _constants.count; i++) {
+                _key.push_back((static_cast<uint64_t>(_constants.entries[i].constantID) << 32) | _constants.data[i]);
+            }
+            std::sort(_key.begin() + first + 1, _key.end());
+        }
+    }
+
+    bool VtPipelineHandle::isReady() const {
+        if (state == nullptr || !state->done.load(std::memory_order_acquire)) {
+            return false;
+        }
+        if (state->failure) {
+            std::rethrow_exception(state->failure);
+        }
+        return true;
+    }
+
+    VtPipeline& VtPipelineHandle::get() const {
+        assert(state != nullptr && "Cannot get the pipeline of an invalid handle");
+        if (isReady()) {
+            return *state->pipeline;
+        }
+        assert(state->fallback != nullptr && "Pipeline is still compiling and there is no fallback");
+        return *state->fallback->pipeline;
+    }
+
+    VtPipelineManager::VtPipelineManager(VtDevice& _device, uint32_t _threadCount) : vtDevice{ _device } {
+        assert(_threadCount > 0 && "Pipeline manager needs at least one compile thread");
+        threads.reserve(_threadCount);
+        for (uint32_t i = 0; i < _threadCount; i++) {
+            threads.emplace_back(&VtPipelineManager::workerLoop, this);
+        }
+    }
+
+    VtPipelineManager::~VtPipelineManager() {
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            stopping = true;
+            queue.clear();
+        }
+        workAvailable.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    VtPipelineHandle VtPipelineManager::createFallback(const std::string& _vertFilepath, const std::string& _fragFilepath, const PipelineConfigInfo& _configInfo) {
+        auto state = std::make_shared<State>();
+        state->vertFilepath = _vertFilepath;
+        state->fragFilepath = _fragFilepath;
+        state->pipeline = std::make_unique<VtPipeline>(vtDevice, _vertFilepath, _fragFilepath, _configInfo);
+        state->done.store(true, std::memory_order_release);
+
+        std::lock_guard<std::mutex> lock{ mutex };
+        fallback = state;
+        return VtPipelineHandle{ std::move(state) };
+    }
+
+    VtPipelineHandle VtPipelineManager::request(const std::string& _vertFilepath, const std::string& _fragFilepath, std::unique_ptr<PipelineConfigInfo> _configInfo) {
+        auto state = std::make_shared<State>();
+        state->vertFilepath = _vertFilepath;
+        state->fragFilepath = _fragFilepath;
+        state->configInfo = std::move(_configInfo);
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            state->fallback = fallback;
+            queue.push_back(state);
+        }
+        workAvailable.notify_one();
+        return VtPipelineHandle{ std::move(state) };
+    }
+
+    VtPipelineHandle VtPipelineManager::requestVariant(const std::string& _vertFilepath, const std::string& _fragFilepath, std::unique_ptr<PipelineConfigInfo> _configInfo) {
+        VariantKey key{ _vertFilepath, _fragFilepath, VtPipeline::hashConfigInfo(*_configInfo), {} };
+        appendSpecialization(key.specialization, _configInfo->vertexSpecialization);
+        appendSpecialization(key.specialization, _configInfo->fragmentSpecialization);
+
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            auto cached = variants.find(key);
+            if (cached != variants.end()) {
+                return cached->second;
+            }
+        }
+
+        // Should another thread have requested the same variant meanwhile, its handle wins and this
+        // request, no longer referenced by anyone, is skipped by the workers.
+        VtPipelineHandle handle = request(_vertFilepath, _fragFilepath, std::move(_configInfo));
+        std::lock_guard<std::mutex> lock{ mutex };
+        return variants.emplace(std::move(key), std::move(handle)).first->second;
+    }
+
+    void VtPipelineManager::clearVariants() {
+        std::lock_guard<std::mutex> lock{ mutex };
+        variants.clear();
+    }
+
+    void VtPipelineManager::wait(const VtPipelineHandle& _handle) {
+        assert(_handle.isValid() && "Cannot wait on an invalid handle");
+        std::unique_lock<std::mutex> lock{ mutex };
+        compiled.wait(lock, [&]() { return _handle.state->done.load(std::memory_order_acquire); });
+    }
+
+    void VtPipelineManager::workerLoop() {
+        std::unique_lock<std::mutex> lock{ mutex };
+        while (true) {
+            workAvailable.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (stopping) {
+                return;
+            }
+            std::shared_ptr<State> state = std::move(queue.front());
+            queue.pop_front();
+
+            // The queue held the last reference: every handle was dropped before its turn, so skip it.
+            if (state.use_count() == 1) {
+                continue;
+            }
+
+            lock.unlock();
+            compile(*state);
+            lock.lock();
+
+            // Published under the mutex so wait() cannot check the flag and then miss the notification.
+            state->done.store(true, std::memory_order_release);
+            compiled.notify_all();
+        }
+    }
+
+    void VtPipelineManager::compile(State& _state) {
+        try {
+            _state.pipeline = std::make_unique<VtPipeline>(vtDevice, _state.vertFilepath, _state.fragFilepath, *_state.configInfo);
+        }
+        catch (...) {
+            _state.failure = std::current_exception();
+        }
+        _state.configInfo.reset();
+    }
+}
\ No newline at end of file
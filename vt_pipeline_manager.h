@@ -0,0 +1,116 @@
+#pragma once
+
+#include "vt_device.h"
+#include "vt_pipeline.h"
+
+//std
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace vt {
+
+    // A pipeline VtPipelineManager compiles in the background. Until it is ready the handle hands out
+    // the manager's fallback pipeline, so frames keep recording instead of waiting on the driver.
+    // Copies share the pipeline, which is destroyed with the last of them; as with any pipeline, only
+    // drop it once the GPU is done with it.
+    class VtPipelineHandle {
+    public:
+        VtPipelineHandle() = default;
+
+        bool isValid() const { return state != nullptr; }
+        // True once compiled, false for invalid handles. Rethrows the exception compilation failed with.
+        bool isReady() const;
+        // The compiled pipeline, or the fallback while it is not ready.
+        VtPipeline& get() const;
+        VtPipeline* operator->() const { return &get(); }
+
+    private:
+        friend class VtPipelineManager;
+
+        struct State {
+            std::string vertFilepath;
+            std::string fragFilepath;
+            std::unique_ptr<PipelineConfigInfo> configInfo;
+            std::unique_ptr<VtPipeline> pipeline;
+            std::exception_ptr failure;
+            std::atomic<bool> done{ false };
+            std::shared_ptr<State> fallback;
+        };
+
+        explicit VtPipelineHandle(std::shared_ptr<State> _state) : state{ std::move(_state) } {}
+
+        std::shared_ptr<State> state;
+    };
+
+    // Compiles graphics pipelines on its own threads through the device's shared VkPipelineCache, so
+    // new materials or shader variants added at runtime never stall a frame for the whole compile.
+    class VtPipelineManager {
+    public:
+        VtPipelineManager(VtDevice& _device, uint32_t _threadCount = 1);
+        // Drops requests that have not started and waits for the ones being compiled.
+        ~VtPipelineManager();
+
+        VtPipelineManager(const VtPipelineManager&) = delete;
+        VtPipelineManager& operator=(const VtPipelineManager&) = delete;
+
+        // Compiles on the calling thread and stands in for every handle requested afterwards until it is
+        // ready. It must be usable wherever they are: the same render pass, and a compatible layout and
+        // vertex input. Callers whose pipelines are not interchangeable check isReady and pick a path.
+        VtPipelineHandle createFallback(const std::string& _vertFilepath, const std::string& _fragFilepath, const PipelineConfigInfo& _configInfo);
+
+        // Queues a compile and returns at once. The config is heap allocated so the pointers inside it
+        // stay valid, and is released once the pipeline is built.
+        VtPipelineHandle request(const std::string& _vertFilepath, const std::string& _fragFilepath, std::unique_ptr<PipelineConfigInfo> _configInfo);
+
+        // As request, but variants are cached by shader pair, config hash and specialization values: asking
+        // for one again returns the handle already compiled or compiling, and drops _configInfo.
+        VtPipelineHandle requestVariant(const std::string& _vertFilepath, const std::string& _fragFilepath, std::unique_ptr<PipelineConfigInfo> _configInfo);
+        // Forgets every cached variant, e.g. once the render pass they were built for is gone. Handles
+        // already handed out keep their pipelines.
+        void clearVariants();
+
+        // Blocks until _handle has compiled or failed.
+        void wait(const VtPipelineHandle& _handle);
+
+        uint32_t threadCount() const { return static_cast<uint32_t>(threads.size()); }
+
+    private:
+        using State = VtPipelineHandle::State;
+
+        struct VariantKey {
+            std::string vertFilepath;
+            std::string fragFilepath;
+            size_t configHash;
+            // Both stages' (constant_id, value) pairs, sorted by id, each stage prefixed with its count.
+            std::vector<uint64_t> specialization;
+
+            bool operator<(const VariantKey& _other) const {
+                return std::tie(vertFilepath, fragFilepath, configHash, specialization)
+                    < std::tie(_other.vertFilepath, _other.fragFilepath, _other.configHash, _other.specialization);
+            }
+        };
+
+        void workerLoop();
+        void compile(State& _state);
+
+        VtDevice& vtDevice;
+        std::shared_ptr<State> fallback;
+        std::map<VariantKey, VtPipelineHandle> variants;
+
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable compiled;
+        std::deque<std::shared_ptr<State>> queue;
+        bool stopping = false;
+    };
+}
\ No newline at end of file
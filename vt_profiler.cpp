@@ -0,0 +1,178 @@
+#include "vt_profiler.h"
+
+//std
+#include <cassert>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace vt {
+
+    VtProfiler::VtProfiler(VtDevice& _device, uint32_t _frameCount)
+        : vtDevice{ _device }, epoch{ std::chrono::steady_clock::now() }, frames(_frameCount), events(MAX_EVENTS) {
+        // Without timestamp support on the graphics queue the profiler still records CPU scopes.
+        uint32_t validBits = vtDevice.findPhysicalQueueFamilies().graphicsTimestampValidBits;
+        if (validBits == 0) {
+            return;
+        }
+
+        timestampPeriod = vtDevice.properties.limits.timestampPeriod;
+        timestampMask = validBits >= 64 ? std::numeric_limits<uint64_t>::max() : (uint64_t{ 1 } << validBits) - 1;
+
+        for (auto& frame : frames) {
+            VkQueryPoolCreateInfo queryPoolInfo{};
+            queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            queryPoolInfo.queryCount = MAX_GPU_ZONES_PER_FRAME * 2;
+
+            if (vkCreateQueryPool(vtDevice.device(), &queryPoolInfo, nullptr, &frame.queryPool) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create timestamp query pool!");
+            }
+        }
+    }
+
+    VtProfiler::~VtProfiler() {
+        for (auto& frame : frames) {
+            if (frame.queryPool != VK_NULL_HANDLE) {
+                vkDestroyQueryPool(vtDevice.device(), frame.queryPool, nullptr);
+            }
+        }
+    }
+
+    void VtProfiler::beginFrame(uint32_t _frameIndex, VkCommandBuffer _commandBuffer) {
+        assert(_frameIndex < frames.size() && "Frame index out of range");
+
+        Frame& frame = frames[_frameIndex];
+        recordingFrame = &frame;
+        if (!hasGpuTimestamps()) {
+            return;
+        }
+
+        if (frame.submitted) {
+            collectFrame(frame);
+        }
+
+        frame.zones.clear();
+        frame.queryCount = 0;
+        frame.submitted = false;
+        vkCmdResetQueryPool(_commandBuffer, frame.queryPool, 0, MAX_GPU_ZONES_PER_FRAME * 2);
+    }
+
+    void VtProfiler::markSubmit(uint32_t _frameIndex) {
+        Frame& frame = frames[_frameIndex];
+        frame.submitted = true;
+        frame.submitMicroseconds = toMicroseconds(std::chrono::steady_clock::now());
+    }
+
+    void VtProfiler::collectAll() {
+        if (!hasGpuTimestamps()) {
+            return;
+        }
+
+        for (auto& frame : frames) {
+            if (frame.submitted) {
+                collectFrame(frame);
+            }
+            // Cleared so a later beginFrame on the slot does not push the same zones again.
+            frame.zones.clear();
+            frame.queryCount = 0;
+            frame.submitted = false;
+        }
+    }
+
+    uint32_t VtProfiler::beginGpuZone(VkCommandBuffer _commandBuffer, const char* _name) {
+        if (!hasGpuTimestamps() || recordingFrame == nullptr || recordingFrame->zones.size() >= MAX_GPU_ZONES_PER_FRAME) {
+            return std::numeric_limits<uint32_t>::max();
+        }
+
+        GpuZone zone{ _name, recordingFrame->queryCount, recordingFrame->queryCount + 1 };
+        recordingFrame->queryCount += 2;
+        vkCmdWriteTimestamp(_commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, recordingFrame->queryPool, zone.beginQuery);
+        recordingFrame->zones.push_back(zone);
+        return static_cast<uint32_t>(recordingFrame->zones.size() - 1);
+    }
+
+    void VtProfiler::endGpuZone(VkCommandBuffer _commandBuffer, uint32_t _zone) {
+        if (_zone == std::numeric_limits<uint32_t>::max()) {
+            return;
+        }
+        vkCmdWriteTimestamp(_commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, recordingFrame->queryPool, recordingFrame->zones[_zone].endQuery);
+    }
+
+    void VtProfiler::recordCpuEvent(const char* _name, std::chrono::steady_clock::time_point _start, std::chrono::steady_clock::time_point _end) {
+        double start = toMicroseconds(_start);
+        push({ _name, currentThreadId(), false, start, toMicroseconds(_end) - start });
+    }
+
+    void VtProfiler::writeChromeTrace(const std::string& _filepath) {
+        std::ofstream file{ _filepath, std::ios::trunc };
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file: " + _filepath);
+        }
+
+        std::lock_guard<std::mutex> lock{ mutex };
+
+        // GPU zones get their own process row so they line up under the CPU frame that submitted them.
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"CPU\"}},\n";
+        file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"GPU\"}}";
+
+        size_t count = wrapped ? events.size() : nextEvent;
+        size_t first = wrapped ? nextEvent : 0;
+        for (size_t i = 0; i < count; i++) {
+            const Event& event = events[(first + i) % events.size()];
+            file << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":" << (event.gpu ? 1 : 0)
+                << ",\"tid\":" << event.threadId << ",\"ts\":" << event.startMicroseconds
+                << ",\"dur\":" << event.durationMicroseconds << "}";
+        }
+        file << "\n]}\n";
+    }
+
+    void VtProfiler::collectFrame(Frame& _frame) {
+        if (_frame.queryCount == 0) {
+            return;
+        }
+
+        // The frame's fence has signalled, so this never waits; a result that is somehow not ready is dropped.
+        std::vector<uint64_t> timestamps(_frame.queryCount);
+        VkResult result = vkGetQueryPoolResults(
+            vtDevice.device(),
+            _frame.queryPool,
+            0,
+            _frame.queryCount,
+            timestamps.size() * sizeof(uint64_t),
+            timestamps.data(),
+            sizeof(uint64_t),
+            VK_QUERY_RESULT_64_BIT);
+        if (result != VK_SUCCESS) {
+            return;
+        }
+
+        // GPU ticks share no clock with the CPU, so zones are laid out relative to the frame's submit time.
+        uint64_t frameStart = timestamps[_frame.zones.front().beginQuery] & timestampMask;
+        for (const auto& zone : _frame.zones) {
+            uint64_t begin = timestamps[zone.beginQuery] & timestampMask;
+            uint64_t end = timestamps[zone.endQuery] & timestampMask;
+            double beginMicroseconds = static_cast<double>(begin - frameStart) * timestampPeriod / 1000.0;
+            double durationMicroseconds = static_cast<double>(end - begin) * timestampPeriod / 1000.0;
+            push({ zone.name, 0, true, _frame.submitMicroseconds + beginMicroseconds, durationMicroseconds });
+        }
+    }
+
+    void VtProfiler::push(const Event& _event) {
+        std::lock_guard<std::mutex> lock{ mutex };
+        events[nextEvent] = _event;
+        nextEvent = (nextEvent + 1) % events.size();
+        wrapped = wrapped || nextEvent == 0;
+    }
+
+    double VtProfiler::toMicroseconds(std::chrono::steady_clock::time_point _time) const {
+        return std::chrono::duration<double, std::micro>(_time - epoch).count();
+    }
+
+    uint32_t VtProfiler::currentThreadId() {
+        return static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    }
+}
\ No newline at end of file
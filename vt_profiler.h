@@ -0,0 +1,133 @@
+#pragma once
+
+#include "vt_device.h"
+
+//std
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace vt {
+
+    // Collects CPU scopes and GPU timestamp zones into a fixed size ring, exportable as Chrome trace
+    // JSON (chrome://tracing or ui.perfetto.dev). The newest events overwrite the oldest.
+    class VtProfiler {
+    public:
+        static constexpr uint32_t MAX_EVENTS = 16384;
+        static constexpr uint32_t MAX_GPU_ZONES_PER_FRAME = 32;
+
+        VtProfiler(VtDevice& _device, uint32_t _frameCount);
+        ~VtProfiler();
+
+        VtProfiler(const VtProfiler&) = delete;
+        VtProfiler& operator=(const VtProfiler&) = delete;
+
+        // Call first thing in the frame's command buffer, after its fence has signalled. Collects the
+        // timestamps the frame wrote last time round without waiting, then resets its queries.
+        void beginFrame(uint32_t _frameIndex, VkCommandBuffer _commandBuffer);
+
+        // Marks the CPU time the frame was submitted; its GPU zones are placed on the trace relative to it.
+        void markSubmit(uint32_t _frameIndex);
+
+        // Returns the zone index to hand to endGpuZone, or UINT32_MAX when out of queries.
+        uint32_t beginGpuZone(VkCommandBuffer _commandBuffer, const char* _name);
+        void endGpuZone(VkCommandBuffer _commandBuffer, uint32_t _zone);
+
+        // Collects every submitted frame still waiting on its slot to come round again. Call once the
+        // device is idle, before writing the trace, or the last frames in flight are missing from it.
+        void collectAll();
+
+        void recordCpuEvent(const char* _name, std::chrono::steady_clock::time_point _start, std::chrono::steady_clock::time_point _end);
+
+        void writeChromeTrace(const std::string& _filepath);
+
+        bool hasGpuTimestamps() const { return timestampPeriod > 0.0f; }
+
+    private:
+        struct Event {
+            const char* name;
+            uint32_t threadId;
+            bool gpu;
+            double startMicroseconds;
+            double durationMicroseconds;
+        };
+
+        struct GpuZone {
+            const char* name;
+            uint32_t beginQuery;
+            uint32_t endQuery;
+        };
+
+        struct Frame {
+            VkQueryPool queryPool = VK_NULL_HANDLE;
+            std::vector<GpuZone> zones;
+            uint32_t queryCount = 0;
+            bool submitted = false;
+            double submitMicroseconds = 0.0;
+        };
+
+        void collectFrame(Frame& _frame);
+        void push(const Event& _event);
+        double toMicroseconds(std::chrono::steady_clock::time_point _time) const;
+        uint32_t currentThreadId();
+
+        VtDevice& vtDevice;
+        float timestampPeriod = 0.0f;
+        uint64_t timestampMask = 0;
+        std::chrono::steady_clock::time_point epoch;
+
+        std::vector<Frame> frames;
+        Frame* recordingFrame = nullptr;
+
+        std::mutex mutex;
+        std::vector<Event> events;
+        size_t nextEvent = 0;
+        bool wrapped = false;
+    };
+
+    // Times the enclosing scope on the CPU. A null profiler makes it a no-op.
+    class VtCpuScope {
+    public:
+        VtCpuScope(VtProfiler* _profiler, const char* _name)
+            : profiler{ _profiler }, name{ _name }, start{ std::chrono::steady_clock::now() } {}
+        ~VtCpuScope() {
+            if (profiler != nullptr) {
+                profiler->recordCpuEvent(name, start, std::chrono::steady_clock::now());
+            }
+        }
+
+        VtCpuScope(const VtCpuScope&) = delete;
+        VtCpuScope& operator=(const VtCpuScope&) = delete;
+
+    private:
+        VtProfiler* profiler;
+        const char* name;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // Brackets the enclosing scope with timestamps in _commandBuffer. Must open and close on the same
+    // side of a render pass boundary. A null profiler makes it a no-op.
+    class VtGpuScope {
+    public:
+        VtGpuScope(VtProfiler* _profiler, VkCommandBuffer _commandBuffer, const char* _name)
+            : profiler{ _profiler }, commandBuffer{ _commandBuffer } {
+            if (profiler != nullptr) {
+                zone = profiler->beginGpuZone(commandBuffer, _name);
+            }
+        }
+        ~VtGpuScope() {
+            if (profiler != nullptr) {
+                profiler->endGpuZone(commandBuffer, zone);
+            }
+        }
+
+        VtGpuScope(const VtGpuScope&) = delete;
+        VtGpuScope& operator=(const VtGpuScope&) = delete;
+
+    private:
+        VtProfiler* profiler;
+        VkCommandBuffer commandBuffer;
+        uint32_t zone = 0;
+    };
+}
\ No newline at end of file
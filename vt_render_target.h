@@ -0,0 +1,133 @@
+#pragma once
+
+//vulkan
+#include <vulkan/vulkan.h>
+
+//std
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace vt {
+
+    // How many frames are queued ahead and how they are presented. Throughput rigs want more frames and
+    // images in flight; interactive use wants as few as the GPU tolerates.
+    struct VtFrameSettings {
+        static constexpr uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;
+
+        // Used when the surface supports it, otherwise FIFO, which every surface must support.
+        VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+        uint32_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT;
+        // Images in the swap chain or offscreen ring; 0 picks minImageCount + 1 (framesInFlight + 1 offscreen).
+        uint32_t imageCount = 0;
+        // Pace frames with the device's graphics timeline instead of a fence per frame and per image.
+        // Ignored, with a message, when the device has no timeline semaphores.
+        bool useTimelineSemaphores = false;
+        // Create the per-frame depth images as transient attachments, in lazily allocated memory where the
+        // device has it, so tile-based GPUs never write depth out to memory.
+        bool useTransientDepth = false;
+    };
+
+    inline const char* presentModeName(VkPresentModeKHR _mode) {
+        switch (_mode) {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR: return "immediate";
+        case VK_PRESENT_MODE_MAILBOX_KHR: return "mailbox";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "fifo-relaxed";
+        case VK_PRESENT_MODE_FIFO_KHR: return "fifo";
+        default: return "unknown";
+        }
+    }
+
+    // Parses the command line spelling of a present mode: fifo, fifo-relaxed, mailbox or immediate.
+    inline bool parsePresentMode(const char* _name, VkPresentModeKHR& _mode) {
+        if (std::strcmp(_name, "fifo") == 0) {
+            _mode = VK_PRESENT_MODE_FIFO_KHR;
+        }
+        else if (std::strcmp(_name, "fifo-relaxed") == 0) {
+            _mode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+        }
+        else if (std::strcmp(_name, "mailbox") == 0) {
+            _mode = VK_PRESENT_MODE_MAILBOX_KHR;
+        }
+        else if (std::strcmp(_name, "immediate") == 0) {
+            _mode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+        }
+        else {
+            return false;
+        }
+        return true;
+    }
+
+    // What FirstApp renders a frame into: either the window's swap chain or an offscreen image ring.
+    // Both keep framesInFlight() frames queued, each guarded by its own fence, and hand out
+    // framebuffers by the image index returned from acquireNextImage. Depth is kept per frame in flight,
+    // so a framebuffer pairs that image with the current frame's depth: fetch it between
+    // acquireNextImage and submitCommandBuffers.
+    class VtRenderTarget {
+    public:
+        virtual ~VtRenderTarget() = default;
+
+        virtual VkFramebuffer getFrameBuffer(int index) = 0;
+        virtual VkRenderPass getRenderPass() = 0;
+        virtual size_t imageCount() = 0;
+        virtual VkExtent2D getExtent() = 0;
+        virtual uint32_t getCurrentFrame() = 0;
+        virtual uint32_t framesInFlight() = 0;
+
+        // Waits for the current frame's fence, then picks the image to render into.
+        virtual VkResult acquireNextImage(uint32_t* imageIndex) = 0;
+        virtual VkResult submitCommandBuffers(const VkCommandBuffer* buffers, uint32_t* imageIndex) = 0;
+
+        // Milliseconds from vkQueueSubmit until the frame's fence was seen signalled, for the frame whose
+        // slot acquireNextImage last reclaimed; negative until a frame has retired. Exact whenever the CPU
+        // had to wait for the fence, otherwise an upper bound.
+        double getLastFrameLatency() const { return lastFrameLatency; }
+
+        // Frames submitted so far, and how many of those are known to have completed on the GPU. Frames
+        // retire in submission order, so anything a frame up to getRetiredFrameCount() used is free to go.
+        uint64_t getSubmittedFrameCount() const { return submittedFrameCount; }
+        uint64_t getRetiredFrameCount() const { return retiredFrameCount; }
+
+    protected:
+        void markSubmitted(uint32_t _frame) {
+            if (submitTimes.size() <= _frame) {
+                submitTimes.resize(_frame + 1);
+                submitted.resize(_frame + 1, false);
+                submissionNumbers.resize(_frame + 1, 0);
+            }
+            submitTimes[_frame] = std::chrono::steady_clock::now();
+            submitted[_frame] = true;
+            submissionNumbers[_frame] = ++submittedFrameCount;
+        }
+
+        void markRetired(uint32_t _frame) {
+            if (_frame < submitted.size() && submitted[_frame]) {
+                lastFrameLatency = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - submitTimes[_frame]).count();
+                submitted[_frame] = false;
+                retiredFrameCount = std::max(retiredFrameCount, submissionNumbers[_frame]);
+            }
+        }
+
+        // Continues counting where _previous left off, for a target that takes over its frame slots.
+        void inheritFrameHistory(VtRenderTarget& _previous) {
+            submitTimes = std::move(_previous.submitTimes);
+            submitted = std::move(_previous.submitted);
+            submissionNumbers = std::move(_previous.submissionNumbers);
+            lastFrameLatency = _previous.lastFrameLatency;
+            submittedFrameCount = _previous.submittedFrameCount;
+            retiredFrameCount = _previous.retiredFrameCount;
+        }
+
+    private:
+        std::vector<std::chrono::steady_clock::time_point> submitTimes;
+        std::vector<bool> submitted;
+        // The submittedFrameCount each frame slot was last submitted as.
+        std::vector<uint64_t> submissionNumbers;
+        double lastFrameLatency = -1.0;
+        uint64_t submittedFrameCount = 0;
+        uint64_t retiredFrameCount = 0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,419 @@
+#include "vt_shader_reflection.h"
+
+#include "vt_pipeline.h"
+
+//std
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+
+namespace vt {
+
+    namespace {
+
+        // The subset of the SPIR-V specification the reflection reads.
+        constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+        constexpr size_t HEADER_WORDS = 5;
+
+        enum Op : uint32_t {
+            OpEntryPoint = 15,
+            OpTypeInt = 21,
+            OpTypeFloat = 22,
+            OpTypeVector = 23,
+            OpTypeMatrix = 24,
+            OpTypeImage = 25,
+            OpTypeSampler = 26,
+            OpTypeSampledImage = 27,
+            OpTypeArray = 28,
+            OpTypeRuntimeArray = 29,
+            OpTypeStruct = 30,
+            OpTypePointer = 32,
+            OpConstant = 43,
+            OpSpecConstantTrue = 48,
+            OpSpecConstantFalse = 49,
+            OpSpecConstant = 50,
+            OpVariable = 59,
+            OpDecorate = 71,
+            OpMemberDecorate = 72,
+        };
+
+        enum Decoration : uint32_t {
+            DecorationSpecId = 1,
+            DecorationBlock = 2,
+            DecorationBufferBlock = 3,
+            DecorationArrayStride = 6,
+            DecorationMatrixStride = 7,
+            DecorationBuiltIn = 11,
+            DecorationLocation = 30,
+            DecorationBinding = 33,
+            DecorationDescriptorSet = 34,
+            DecorationOffset = 35,
+        };
+
+        enum StorageClass : uint32_t {
+            StorageClassUniformConstant = 0,
+            StorageClassInput = 1,
+            StorageClassUniform = 2,
+            StorageClassPushConstant = 9,
+            StorageClassStorageBuffer = 12,
+        };
+
+        enum ExecutionModel : uint32_t {
+            ExecutionModelVertex = 0,
+            ExecutionModelTessellationControl = 1,
+            ExecutionModelTessellationEvaluation = 2,
+            ExecutionModelGeometry = 3,
+            ExecutionModelFragment = 4,
+            ExecutionModelGLCompute = 5,
+        };
+
+        constexpr uint32_t DIM_BUFFER = 5;
+        constexpr uint32_t DIM_SUBPASS_DATA = 6;
+        constexpr uint32_t NONE = ~0u;
+
+        // Everything known about one result id: the instruction defining it, without the opcode word,
+        // and the decorations applied to it or, for structs, to its members.
+        struct Id {
+            uint32_t opcode = 0;
+            std::vector<uint32_t> operands;
+
+            uint32_t specId = NONE;
+            uint32_t set = NONE;
+            uint32_t binding = NONE;
+            uint32_t location = NONE;
+            uint32_t arrayStride = 0;
+            bool builtIn = false;
+            bool block = false;
+            bool bufferBlock = false;
+            std::vector<uint32_t> memberOffsets;
+            std::vector<uint32_t> memberMatrixStrides;
+        };
+
+        VkShaderStageFlagBits stageOf(uint32_t _executionModel) {
+            switch (_executionModel) {
+            case ExecutionModelVertex: return VK_SHADER_STAGE_VERTEX_BIT;
+            case ExecutionModelTessellationControl: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+            case ExecutionModelTessellationEvaluation: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+            case ExecutionModelGeometry: return VK_SHADER_STAGE_GEOMETRY_BIT;
+            case ExecutionModelFragment: return VK_SHADER_STAGE_FRAGMENT_BIT;
+            case ExecutionModelGLCompute: return VK_SHADER_STAGE_COMPUTE_BIT;
+            default: throw std::runtime_error("Unsupported SPIR-V execution model!");
+            }
+        }
+
+        class Parser {
+        public:
+            explicit Parser(const std::vector<char>& _code) {
+                if (_code.size() % sizeof(uint32_t) != 0 || _code.size() < HEADER_WORDS * sizeof(uint32_t)) {
+                    throw std::runtime_error("SPIR-V code is truncated!");
+                }
+                words.resize(_code.size() / sizeof(uint32_t));
+                memcpy(words.data(), _code.data(), _code.size());
+                if (words[0] != SPIRV_MAGIC) {
+                    throw std::runtime_error("SPIR-V code has a bad magic number!");
+                }
+                ids.resize(words[3]);
+
+                for (size_t i = HEADER_WORDS; i < words.size();) {
+                    uint32_t wordCount = words[i] >> 16;
+                    if (wordCount == 0 || i + wordCount > words.size()) {
+                        throw std::runtime_error("SPIR-V instruction runs past the end of the code!");
+                    }
+                    parseInstruction(words[i] & 0xffffu, &words[i + 1], wordCount - 1);
+                    i += wordCount;
+                }
+            }
+
+            VkShaderStageFlags stages = 0;
+            std::vector<uint32_t> variables;
+            std::vector<uint32_t> specConstants;
+
+            Id& id(uint32_t _id) {
+                if (_id >= ids.size()) {
+                    throw std::runtime_error("SPIR-V id is out of bounds!");
+                }
+                return ids[_id];
+            }
+
+            // The type a pointer-typed id points at.
+            Id& pointee(Id& _variable) {
+                return id(id(_variable.operands[0]).operands[2]);
+            }
+
+            uint32_t constant(uint32_t _id) {
+                Id& value = id(_id);
+                if (value.opcode != OpConstant) {
+                    throw std::runtime_error("SPIR-V array length is not a constant!");
+                }
+                return value.operands[2];
+            }
+
+            // Bytes _type occupies in an explicitly laid out block; _matrixStride comes from the member holding it.
+            uint32_t sizeOf(Id& _type, uint32_t _matrixStride = 0) {
+                switch (_type.opcode) {
+                case OpTypeInt:
+                case OpTypeFloat:
+                    return _type.operands[1] / 8;
+                case OpTypeVector:
+                    return _type.operands[2] * sizeOf(id(_type.operands[1]));
+                case OpTypeMatrix:
+                    return _type.operands[2] * (_matrixStride != 0 ? _matrixStride : sizeOf(id(_type.operands[1])));
+                case OpTypeArray: {
+                    Id& element = id(_type.operands[1]);
+                    return constant(_type.operands[2]) * (_type.arrayStride != 0 ? _type.arrayStride : sizeOf(element));
+                }
+                case OpTypeStruct: {
+                    uint32_t size = 0;
+                    for (size_t member = 1; member < _type.operands.size(); member++) {
+                        size_t index = member - 1;
+                        uint32_t offset = index < _type.memberOffsets.size() ? _type.memberOffsets[index] : 0;
+                        uint32_t stride = index < _type.memberMatrixStrides.size() ? _type.memberMatrixStrides[index] : 0;
+                        size = std::max(size, offset + sizeOf(id(_type.operands[member]), stride));
+                    }
+                    return size;
+                }
+                default:
+                    throw std::runtime_error("Unsupported type in SPIR-V push-constant block!");
+                }
+            }
+
+        private:
+            void parseInstruction(uint32_t _opcode, const uint32_t* _operands, uint32_t _count) {
+                switch (_opcode) {
+                case OpEntryPoint:
+                    if (_count < 1) {
+                        throw std::runtime_error("SPIR-V entry point is truncated!");
+                    }
+                    stages |= stageOf(_operands[0]);
+                    break;
+                case OpTypeInt:
+                case OpTypeFloat:
+                case OpTypeVector:
+                case OpTypeMatrix:
+                case OpTypeImage:
+                case OpTypeSampler:
+                case OpTypeSampledImage:
+                case OpTypeArray:
+                case OpTypeRuntimeArray:
+                case OpTypeStruct:
+                case OpTypePointer:
+                    define(_opcode, _operands[0], _operands, _count);
+                    break;
+                case OpConstant:
+                case OpVariable:
+                    define(_opcode, _operands[1], _operands, _count);
+                    if (_opcode == OpVariable) {
+                        variables.push_back(_operands[1]);
+                    }
+                    break;
+                case OpSpecConstantTrue:
+                case OpSpecConstantFalse:
+                case OpSpecConstant:
+                    define(_opcode, _operands[1], _operands, _count);
+                    specConstants.push_back(_operands[1]);
+                    break;
+                case OpDecorate:
+                    decorate(id(_operands[0]), _operands[1], _count > 2 ? _operands[2] : 0);
+                    break;
+                case OpMemberDecorate:
+                    decorateMember(id(_operands[0]), _operands[1], _operands[2], _count > 3 ? _operands[3] : 0);
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            void define(uint32_t _opcode, uint32_t _result, const uint32_t* _operands, uint32_t _count) {
+                Id& result = id(_result);
+                result.opcode = _opcode;
+                result.operands.assign(_operands, _operands + _count);
+            }
+
+            void decorate(Id& _target, uint32_t _decoration, uint32_t _value) {
+                switch (_decoration) {
+                case DecorationSpecId: _target.specId = _value; break;
+                case DecorationBlock: _target.block = true; break;
+                case DecorationBufferBlock: _target.bufferBlock = true; break;
+                case DecorationArrayStride: _target.arrayStride = _value; break;
+                case DecorationBuiltIn: _target.builtIn = true; break;
+                case DecorationLocation: _target.location = _value; break;
+                case DecorationBinding: _target.binding = _value; break;
+                case DecorationDescriptorSet: _target.set = _value; break;
+                default: break;
+                }
+            }
+
+            void decorateMember(Id& _struct, uint32_t _member, uint32_t _decoration, uint32_t _value) {
+                std::vector<uint32_t>* values = nullptr;
+                switch (_decoration) {
+                case DecorationOffset: values = &_struct.memberOffsets; break;
+                case DecorationMatrixStride: values = &_struct.memberMatrixStrides; break;
+                // A built-in member makes the whole block built-in, like gl_PerVertex.
+                case DecorationBuiltIn: _struct.builtIn = true; return;
+                default: return;
+                }
+                if (values->size() <= _member) {
+                    values->resize(_member + 1, 0);
+                }
+                (*values)[_member] = _value;
+            }
+
+            std::vector<uint32_t> words;
+            std::vector<Id> ids;
+        };
+
+        VkDescriptorType descriptorTypeOf(uint32_t _storageClass, const Id& _type) {
+            switch (_type.opcode) {
+            case OpTypeSampler:
+                return VK_DESCRIPTOR_TYPE_SAMPLER;
+            case OpTypeSampledImage:
+                return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            case OpTypeImage: {
+                uint32_t dim = _type.operands[2];
+                bool storage = _type.operands[6] == 2;
+                if (dim == DIM_SUBPASS_DATA) {
+                    return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                }
+                if (dim == DIM_BUFFER) {
+                    return storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                }
+                return storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            }
+            case OpTypeStruct:
+                // SPIR-V before 1.3 marks storage buffers as Uniform BufferBlocks.
+                if (_storageClass == StorageClassStorageBuffer || _type.bufferBlock) {
+                    return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                }
+                return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            default:
+                throw std::runtime_error("Unsupported SPIR-V descriptor type!");
+            }
+        }
+
+        VkFormat vertexFormatOf(Parser& _parser, const Id& _type) {
+            uint32_t components = 1;
+            const Id* scalar = &_type;
+            if (_type.opcode == OpTypeVector) {
+                components = _type.operands[2];
+                scalar = &_parser.id(_type.operands[1]);
+            }
+
+            static const VkFormat floatFormats[] = { VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT };
+            static const VkFormat intFormats[] = { VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT };
+            static const VkFormat uintFormats[] = { VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT };
+
+            if (components < 1 || components > 4 || scalar->operands.size() < 2 || scalar->operands[1] != 32) {
+                throw std::runtime_error("Unsupported SPIR-V vertex input type!");
+            }
+            if (scalar->opcode == OpTypeFloat) {
+                return floatFormats[components - 1];
+            }
+            if (scalar->opcode == OpTypeInt) {
+                return scalar->operands[2] != 0 ? intFormats[components - 1] : uintFormats[components - 1];
+            }
+            throw std::runtime_error("Unsupported SPIR-V vertex input type!");
+        }
+    }
+
+    VtShaderReflection::VtShaderReflection(const std::vector<char>& _code) {
+        Parser parser{ _code };
+        stages = parser.stages;
+
+        for (uint32_t variableId : parser.variables) {
+            Id& variable = parser.id(variableId);
+            uint32_t storageClass = variable.operands[2];
+            Id& type = parser.pointee(variable);
+
+            if (storageClass == StorageClassPushConstant) {
+                uint32_t offset = type.memberOffsets.empty() ? 0 : *std::min_element(type.memberOffsets.begin(), type.memberOffsets.end());
+                pushConstantRanges.push_back({ stages, offset, parser.sizeOf(type) - offset });
+            }
+            else if (storageClass == StorageClassUniformConstant || storageClass == StorageClassUniform || storageClass == StorageClassStorageBuffer) {
+                if (variable.set == NONE || variable.binding == NONE) {
+                    continue;
+                }
+                uint32_t count = 1;
+                Id* element = &type;
+                if (type.opcode == OpTypeArray) {
+                    count = parser.constant(type.operands[2]);
+                    element = &parser.id(type.operands[1]);
+                }
+                else if (type.opcode == OpTypeRuntimeArray) {
+                    throw std::runtime_error("Unsized descriptor arrays are not supported!");
+                }
+                descriptorBindings.push_back({ variable.set, variable.binding, descriptorTypeOf(storageClass, *element), count, stages });
+            }
+            else if (storageClass == StorageClassInput && (stages & VK_SHADER_STAGE_VERTEX_BIT) != 0) {
+                if (variable.builtIn || type.builtIn || variable.location == NONE) {
+                    continue;
+                }
+                vertexInputs.push_back({ variable.location, vertexFormatOf(parser, type) });
+            }
+        }
+
+        // Constants without a SpecId are only used in spec constant operations and cannot be set.
+        for (uint32_t constantId : parser.specConstants) {
+            uint32_t specId = parser.id(constantId).specId;
+            if (specId != NONE) {
+                specializationConstants.push_back(specId);
+            }
+        }
+        std::sort(specializationConstants.begin(), specializationConstants.end());
+
+        std::sort(descriptorBindings.begin(), descriptorBindings.end(), [](const DescriptorBinding& _a, const DescriptorBinding& _b) {
+            return std::tie(_a.set, _a.binding) < std::tie(_b.set, _b.binding);
+        });
+        std::sort(vertexInputs.begin(), vertexInputs.end(), [](const VertexInput& _a, const VertexInput& _b) {
+            return _a.location < _b.location;
+        });
+    }
+
+    VtShaderReflection VtShaderReflection::fromFile(const std::string& _filepath) {
+        return VtShaderReflection{ VtPipeline::readFile(_filepath) };
+    }
+
+    void VtShaderReflection::merge(const VtShaderReflection& _other) {
+        stages |= _other.stages;
+
+        for (const VkPushConstantRange& range : _other.pushConstantRanges) {
+            auto match = std::find_if(pushConstantRanges.begin(), pushConstantRanges.end(), [&](const VkPushConstantRange& _range) {
+                return _range.offset == range.offset && _range.size == range.size;
+            });
+            if (match != pushConstantRanges.end()) {
+                match->stageFlags |= range.stageFlags;
+            }
+            else {
+                pushConstantRanges.push_back(range);
+            }
+        }
+
+        for (const DescriptorBinding& binding : _other.descriptorBindings) {
+            auto position = std::lower_bound(descriptorBindings.begin(), descriptorBindings.end(), binding, [](const DescriptorBinding& _a, const DescriptorBinding& _b) {
+                return std::tie(_a.set, _a.binding) < std::tie(_b.set, _b.binding);
+            });
+            if (position != descriptorBindings.end() && position->set == binding.set && position->binding == binding.binding) {
+                if (position->type != binding.type || position->count != binding.count) {
+                    throw std::runtime_error("Shader stages disagree on descriptor set " + std::to_string(binding.set) + " binding " + std::to_string(binding.binding) + "!");
+                }
+                position->stages |= binding.stages;
+            }
+            else {
+                descriptorBindings.insert(position, binding);
+            }
+        }
+
+        std::vector<uint32_t> constants;
+        std::set_union(
+            specializationConstants.begin(), specializationConstants.end(),
+            _other.specializationConstants.begin(), _other.specializationConstants.end(),
+            std::back_inserter(constants));
+        specializationConstants = std::move(constants);
+
+        vertexInputs.insert(vertexInputs.end(), _other.vertexInputs.begin(), _other.vertexInputs.end());
+        std::sort(vertexInputs.begin(), vertexInputs.end(), [](const VertexInput& _a, const VertexInput& _b) {
+            return _a.location < _b.location;
+        });
+    }
+}
\ No newline at end of file
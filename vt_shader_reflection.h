@@ -0,0 +1,60 @@
+#pragma once
+
+//vulkan
+#include <vulkan/vulkan.h>
+
+//std
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vt {
+
+    // The interface a SPIR-V module declares: its stages, push-constant ranges, descriptor bindings,
+    // specialization constants and, for vertex shaders, the input locations. Modules of one pipeline
+    // are merged into its signature, which VtLayoutCache turns into a pipeline layout so layouts always
+    // match the shaders they serve.
+    class VtShaderReflection {
+    public:
+        struct DescriptorBinding {
+            uint32_t set;
+            uint32_t binding;
+            VkDescriptorType type;
+            uint32_t count;
+            VkShaderStageFlags stages;
+        };
+
+        struct VertexInput {
+            uint32_t location;
+            VkFormat format;
+        };
+
+        VtShaderReflection() = default;
+        // Parses a module as VtPipeline::readFile loads it; throws when it is not valid SPIR-V or uses
+        // an interface this parser does not understand.
+        explicit VtShaderReflection(const std::vector<char>& _code);
+
+        static VtShaderReflection fromFile(const std::string& _filepath);
+
+        // Adds the stages of _other. Identical push-constant ranges and descriptor bindings are shared
+        // between the stages; a binding declared with a different type or count in _other throws.
+        void merge(const VtShaderReflection& _other);
+
+        VkShaderStageFlags getStages() const { return stages; }
+        // One range per distinct push-constant block, with every stage that declares it.
+        const std::vector<VkPushConstantRange>& getPushConstantRanges() const { return pushConstantRanges; }
+        // Sorted by set, then binding.
+        const std::vector<DescriptorBinding>& getDescriptorBindings() const { return descriptorBindings; }
+        // Sorted by location; built-ins such as gl_VertexIndex are left out.
+        const std::vector<VertexInput>& getVertexInputs() const { return vertexInputs; }
+        // The constant_ids of the specialization constants, sorted.
+        const std::vector<uint32_t>& getSpecializationConstants() const { return specializationConstants; }
+
+    private:
+        VkShaderStageFlags stages = 0;
+        std::vector<VkPushConstantRange> pushConstantRanges;
+        std::vector<DescriptorBinding> descriptorBindings;
+        std::vector<VertexInput> vertexInputs;
+        std::vector<uint32_t> specializationConstants;
+    };
+}
\ No newline at end of file
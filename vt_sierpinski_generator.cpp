@@ -0,0 +1,139 @@
+#include "vt_sierpinski_generator.h"
+
+//std
+#include <stdexcept>
+#include <string>
+
+namespace vt {
+
+    VtSierpinskiGenerator::VtSierpinskiGenerator(VtDevice& _device) : vtDevice{ _device } {
+        createDescriptorSetLayout();
+        createPipelineLayout();
+        createDescriptorPool();
+        computePipeline = std::make_unique<VtComputePipeline>(vtDevice, "shaders/sierpinski.comp.spv", pipelineLayout);
+    }
+
+    VtSierpinskiGenerator::~VtSierpinskiGenerator() {
+        computePipeline.reset();
+        vkDestroyDescriptorPool(vtDevice.device(), descriptorPool, nullptr);
+        vkDestroyPipelineLayout(vtDevice.device(), pipelineLayout, nullptr);
+        vkDestroyDescriptorSetLayout(vtDevice.device(), descriptorSetLayout, nullptr);
+    }
+
+    std::unique_ptr<VtModel> VtSierpinskiGenerator::generate(int _depth, const VtModel::Vertex& _top, const VtModel::Vertex& _right, const VtModel::Vertex& _left) {
+        const auto& limits = vtDevice.properties.limits;
+
+        uint64_t triangleCount = 1;
+        for (int level = 0; level < _depth; level++) {
+            triangleCount *= 3;
+            if (triangleCount * 3 * sizeof(VtModel::Vertex) > limits.maxStorageBufferRange) {
+                throw std::runtime_error("Sierpinski depth " + std::to_string(_depth) + " exceeds the storage buffer range!");
+            }
+        }
+        uint32_t groupCount = VtComputePipeline::groupCount(static_cast<uint32_t>(triangleCount), WORKGROUP_SIZE);
+        if (groupCount > limits.maxComputeWorkGroupCount[0]) {
+            throw std::runtime_error("Sierpinski depth " + std::to_string(_depth) + " exceeds the compute dispatch limit!");
+        }
+
+        PushConstantData push{};
+        push.position[0] = glm::vec4{ _top.position, 0.0f, 0.0f };
+        push.position[1] = glm::vec4{ _right.position, 0.0f, 0.0f };
+        push.position[2] = glm::vec4{ _left.position, 0.0f, 0.0f };
+        push.colour[0] = glm::vec4{ _top.colour, 0.0f };
+        push.colour[1] = glm::vec4{ _right.colour, 0.0f };
+        push.colour[2] = glm::vec4{ _left.colour, 0.0f };
+        push.depth = static_cast<uint32_t>(_depth);
+        push.triangleCount = static_cast<uint32_t>(triangleCount);
+
+        // generate() waits for the dispatch, so the single descriptor set is free again on the next call.
+        vkResetDescriptorPool(vtDevice.device(), descriptorPool, 0);
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = descriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &descriptorSetLayout;
+
+        VkDescriptorSet descriptorSet;
+        if (vkAllocateDescriptorSets(vtDevice.device(), &allocInfo, &descriptorSet) != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate descriptor set!");
+        }
+
+        // Every sub-triangle lies inside the outer one.
+        VtModel::Bounds bounds{};
+        bounds.min = glm::min(glm::min(_top.position, _right.position), _left.position);
+        bounds.max = glm::max(glm::max(_top.position, _right.position), _left.position);
+
+        return std::make_unique<VtModel>(vtDevice, push.triangleCount * 3, bounds, [&](VkCommandBuffer _commandBuffer, VkBuffer _vertexBuffer) {
+            VkDescriptorBufferInfo bufferInfo{};
+            bufferInfo.buffer = _vertexBuffer;
+            bufferInfo.offset = 0;
+            bufferInfo.range = VK_WHOLE_SIZE;
+
+            VkWriteDescriptorSet write{};
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.dstSet = descriptorSet;
+            write.dstBinding = 0;
+            write.descriptorCount = 1;
+            write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            write.pBufferInfo = &bufferInfo;
+            vkUpdateDescriptorSets(vtDevice.device(), 1, &write, 0, nullptr);
+
+            computePipeline->bind(_commandBuffer);
+            vkCmdBindDescriptorSets(_commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+            vkCmdPushConstants(_commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstantData), &push);
+            computePipeline->dispatch(_commandBuffer, groupCount);
+        });
+    }
+
+    void VtSierpinskiGenerator::createDescriptorSetLayout() {
+        VkDescriptorSetLayoutBinding binding{};
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &binding;
+
+        if (vkCreateDescriptorSetLayout(vtDevice.device(), &layoutInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create descriptor set layout!");
+        }
+    }
+
+    void VtSierpinskiGenerator::createPipelineLayout() {
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(PushConstantData);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+        if (vkCreatePipelineLayout(vtDevice.device(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline layout!");
+        }
+    }
+
+    void VtSierpinskiGenerator::createDescriptorPool() {
+        VkDescriptorPoolSize poolSize{};
+        poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSize.descriptorCount = 1;
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.maxSets = 1;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+
+        if (vkCreateDescriptorPool(vtDevice.device(), &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create descriptor pool!");
+        }
+    }
+}
\ No newline at end of file
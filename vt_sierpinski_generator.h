@@ -0,0 +1,46 @@
+#pragma once
+
+#include "vt_device.h"
+#include "vt_compute_pipeline.h"
+#include "vt_model.h"
+
+//std
+#include <memory>
+
+namespace vt {
+
+    // Builds the Sierpinski triangle on the GPU. One compute invocation per leaf triangle walks the
+    // recursion down from its base 3 index and writes its corners straight into a DEVICE_LOCAL vertex
+    // buffer, so nothing is generated or copied on the CPU. Triangles are not welded or indexed.
+    class VtSierpinskiGenerator {
+    public:
+        static constexpr uint32_t WORKGROUP_SIZE = 64;
+
+        explicit VtSierpinskiGenerator(VtDevice& _device);
+        ~VtSierpinskiGenerator();
+
+        VtSierpinskiGenerator(const VtSierpinskiGenerator&) = delete;
+        VtSierpinskiGenerator& operator=(const VtSierpinskiGenerator&) = delete;
+
+        // Throws when 3^_depth triangles exceed the device's storage buffer or dispatch limits.
+        std::unique_ptr<VtModel> generate(int _depth, const VtModel::Vertex& _top, const VtModel::Vertex& _right, const VtModel::Vertex& _left);
+
+    private:
+        struct PushConstantData {
+            glm::vec4 position[3];
+            glm::vec4 colour[3];
+            uint32_t depth;
+            uint32_t triangleCount;
+        };
+
+        void createDescriptorSetLayout();
+        void createPipelineLayout();
+        void createDescriptorPool();
+
+        VtDevice& vtDevice;
+        VkDescriptorSetLayout descriptorSetLayout;
+        VkPipelineLayout pipelineLayout;
+        VkDescriptorPool descriptorPool;
+        std::unique_ptr<VtComputePipeline> computePipeline;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+//vulkan
+#include <vulkan/vulkan.h>
+
+//std
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+namespace vt {
+
+    // Values for one shader stage's specialization constants, by constant_id. Every value takes 32 bits,
+    // which covers the bool, int, uint and float constants GLSL declares; bools are stored as VkBool32.
+    // Held inline like VtVertexInput, so pipeline configs stay allocation free.
+    struct VtSpecializationConstants {
+        static constexpr uint32_t MAX_CONSTANTS = 8;
+
+        std::array<VkSpecializationMapEntry, MAX_CONSTANTS> entries{};
+        std::array<uint32_t, MAX_CONSTANTS> data{};
+        uint32_t count = 0;
+
+        // Setting a constant again replaces its value.
+        VtSpecializationConstants& set(uint32_t _constantId, uint32_t _value) {
+            for (uint32_t i = 0; i < count; i++) {
+                if (entries[i].constantID == _constantId) {
+                    data[i] = _value;
+                    return *this;
+                }
+            }
+            assert(count < MAX_CONSTANTS && "Too many specialization constants");
+            entries[count] = { _constantId, count * static_cast<uint32_t>(sizeof(uint32_t)), sizeof(uint32_t) };
+            data[count] = _value;
+            count++;
+            return *this;
+        }
+        VtSpecializationConstants& set(uint32_t _constantId, int32_t _value) { return set(_constantId, static_cast<uint32_t>(_value)); }
+        VtSpecializationConstants& set(uint32_t _constantId, bool _value) { return set(_constantId, static_cast<uint32_t>(_value ? VK_TRUE : VK_FALSE)); }
+        VtSpecializationConstants& set(uint32_t _constantId, float _value) {
+            uint32_t bits;
+            memcpy(&bits, &_value, sizeof(bits));
+            return set(_constantId, bits);
+        }
+
+        bool empty() const { return count == 0; }
+
+        // Points into this object, which has to outlive the pipeline creation the info is passed to.
+        VkSpecializationInfo getInfo() const {
+            VkSpecializationInfo info{};
+            info.mapEntryCount = count;
+            info.pMapEntries = entries.data();
+            info.dataSize = count * sizeof(uint32_t);
+            info.pData = data.data();
+            return info;
+        }
+    };
+}
\ No newline at end of file
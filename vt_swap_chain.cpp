@@ -1,28 +1,33 @@
 #include "vt_swap_chain.h"
 
 // std
+#include <algorithm>
 #include <array>
+#include <cassert>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <limits>
+#include <mutex>
 #include <set>
 #include <stdexcept>
 
 namespace vt {
 
-    VtSwapChain::VtSwapChain(VtDevice& deviceRef, VkExtent2D extent)
-        : device{ deviceRef }, windowExtent{ extent } {
+    VtSwapChain::VtSwapChain(VtDevice& deviceRef, VkExtent2D extent, const VtFrameSettings& _settings)
+        : device{ deviceRef }, windowExtent{ extent }, frameSettings{ _settings } {
         init();
     }
 
-    VtSwapChain::VtSwapChain(VtDevice& deviceRef, VkExtent2D extent, std::shared_ptr<VtSwapChain> _previous)
-        : device{ deviceRef }, windowExtent{ extent }, oldSwapChain{ _previous } {
+    VtSwapChain::VtSwapChain(VtDevice& deviceRef, VkExtent2D extent, std::shared_ptr<VtSwapChain> _previous, const VtFrameSettings& _settings)
+        : device{ deviceRef }, windowExtent{ extent }, frameSettings{ _settings }, oldSwapChain{ _previous } {
         init();
         oldSwapChain = nullptr;
     }
 
     VtSwapChain::~VtSwapChain() {
+        waitForPresents();
+
         for (auto imageView : swapChainImageViews) {
             vkDestroyImageView(device.device(), imageView, nullptr);
         }
@@ -33,42 +38,73 @@ namespace vt {
             swapChain = nullptr;
         }
 
-        for (int i = 0; i < depthImages.size(); i++) {
-            vkDestroyImageView(device.device(), depthImageViews[i], nullptr);
-            vkDestroyImage(device.device(), depthImages[i], nullptr);
-            vkFreeMemory(device.device(), depthImageMemorys[i], nullptr);
-        }
-
         for (auto framebuffer : swapChainFramebuffers) {
             vkDestroyFramebuffer(device.device(), framebuffer, nullptr);
         }
+        depthAttachments.reset();
 
         vkDestroyRenderPass(device.device(), renderPass, nullptr);
 
         // cleanup synchronization objects
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        for (size_t i = 0; i < imageAvailableSemaphores.size(); i++) {
             vkDestroySemaphore(device.device(), renderFinishedSemaphores[i], nullptr);
             vkDestroySemaphore(device.device(), imageAvailableSemaphores[i], nullptr);
-            vkDestroyFence(device.device(), inFlightFences[i], nullptr);
+        }
+        for (auto fence : inFlightFences) {
+            vkDestroyFence(device.device(), fence, nullptr);
+        }
+        for (auto fence : presentFences) {
+            vkDestroyFence(device.device(), fence, nullptr);
+        }
+    }
+
+    void VtSwapChain::waitForPresents() {
+        if (!presentFences.empty()) {
+            vkWaitForFences(
+                device.device(),
+                static_cast<uint32_t>(presentFences.size()),
+                presentFences.data(),
+                VK_TRUE,
+                std::numeric_limits<uint64_t>::max());
+        }
+        else if (hasPresented) {
+            std::lock_guard<std::mutex> lock{ device.queueMutex(device.presentQueue()) };
+            vkQueueWaitIdle(device.presentQueue());
         }
     }
 
     void VtSwapChain::init() {
         createSwapChain();
         createImageViews();
-        createRenderPass();
+        swapChainDepthFormat = findDepthFormat();
+
+        // A render pass only depends on the attachment formats, so keep the old one when they are unchanged;
+        // pipelines built against it then stay valid across the resize.
+        if (oldSwapChain != nullptr && compareSwapFormats(*oldSwapChain)) {
+            renderPass = oldSwapChain->renderPass;
+            oldSwapChain->renderPass = VK_NULL_HANDLE;
+        }
+        else {
+            createRenderPass();
+        }
         createDepthResources();
         createFramebuffers();
         createSyncObjects();
     }
 
     VkResult VtSwapChain::acquireNextImage(uint32_t* imageIndex) {
-        vkWaitForFences(
-            device.device(),
-            1,
-            &inFlightFences[currentFrame],
-            VK_TRUE,
-            std::numeric_limits<uint64_t>::max());
+        if (timeline != nullptr) {
+            timeline->wait(frameValues[currentFrame]);
+        }
+        else {
+            vkWaitForFences(
+                device.device(),
+                1,
+                &inFlightFences[currentFrame],
+                VK_TRUE,
+                std::numeric_limits<uint64_t>::max());
+        }
+        markRetired(static_cast<uint32_t>(currentFrame));
 
         VkResult result = vkAcquireNextImageKHR(
             device.device(),
@@ -83,10 +119,13 @@ namespace vt {
 
     VkResult VtSwapChain::submitCommandBuffers(
         const VkCommandBuffer* buffers, uint32_t* imageIndex) {
-        if (imagesInFlight[*imageIndex] != VK_NULL_HANDLE) {
+        // Usually already retired, which the timeline answers without calling into the driver.
+        if (timeline != nullptr) {
+            timeline->wait(imageValues[*imageIndex]);
+        }
+        else if (imagesInFlight[*imageIndex] != VK_NULL_HANDLE) {
             vkWaitForFences(device.device(), 1, &imagesInFlight[*imageIndex], VK_TRUE, UINT64_MAX);
         }
-        imagesInFlight[*imageIndex] = inFlightFences[currentFrame];
 
         VkSubmitInfo submitInfo = {};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -100,15 +139,42 @@ namespace vt {
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = buffers;
 
-        VkSemaphore signalSemaphores[] = { renderFinishedSemaphores[currentFrame] };
+        VkSemaphore signalSemaphores[] = { renderFinishedSemaphores[currentFrame], VK_NULL_HANDLE };
         submitInfo.signalSemaphoreCount = 1;
         submitInfo.pSignalSemaphores = signalSemaphores;
 
-        vkResetFences(device.device(), 1, &inFlightFences[currentFrame]);
-        if (vkQueueSubmit(device.graphicsQueue(), 1, &submitInfo, inFlightFences[currentFrame]) !=
-            VK_SUCCESS) {
+        // The binary semaphore's value is ignored, only the timeline's counts.
+        uint64_t signalValues[] = { 0, 0 };
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        VkFence fence = VK_NULL_HANDLE;
+        if (timeline != nullptr) {
+            signalSemaphores[1] = timeline->handle();
+            signalValues[1] = timeline->advance();
+            submitInfo.signalSemaphoreCount = 2;
+
+            timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+            timelineInfo.signalSemaphoreValueCount = 2;
+            timelineInfo.pSignalSemaphoreValues = signalValues;
+            submitInfo.pNext = &timelineInfo;
+
+            frameValues[currentFrame] = signalValues[1];
+            imageValues[*imageIndex] = signalValues[1];
+        }
+        else {
+            fence = inFlightFences[currentFrame];
+            imagesInFlight[*imageIndex] = fence;
+            vkResetFences(device.device(), 1, &fence);
+        }
+
+        VkResult submitResult;
+        {
+            std::lock_guard<std::mutex> lock{ device.queueMutex(device.graphicsQueue()) };
+            submitResult = vkQueueSubmit(device.graphicsQueue(), 1, &submitInfo, fence);
+        }
+        if (submitResult != VK_SUCCESS) {
             throw std::runtime_error("failed to submit draw command buffer!");
         }
+        markSubmitted(static_cast<uint32_t>(currentFrame));
 
         VkPresentInfoKHR presentInfo = {};
         presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -122,9 +188,28 @@ namespace vt {
 
         presentInfo.pImageIndices = imageIndex;
 
-        auto result = vkQueuePresentKHR(device.presentQueue(), &presentInfo);
+#ifdef VK_EXT_swapchain_maintenance1
+        VkSwapchainPresentFenceInfoEXT presentFenceInfo{};
+        if (!presentFences.empty()) {
+            // The slot's previous present finished long ago in practice; this only guards the fence's reuse.
+            vkWaitForFences(device.device(), 1, &presentFences[currentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max());
+            vkResetFences(device.device(), 1, &presentFences[currentFrame]);
+
+            presentFenceInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_PRESENT_FENCE_INFO_EXT;
+            presentFenceInfo.swapchainCount = 1;
+            presentFenceInfo.pFences = &presentFences[currentFrame];
+            presentInfo.pNext = &presentFenceInfo;
+        }
+#endif
+        hasPresented = true;
 
-        currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+        VkResult result;
+        {
+            std::lock_guard<std::mutex> lock{ device.queueMutex(device.presentQueue()) };
+            result = vkQueuePresentKHR(device.presentQueue(), &presentInfo);
+        }
+
+        currentFrame = (currentFrame + 1) % frameSettings.framesInFlight;
 
         return result;
     }
@@ -133,10 +218,12 @@ namespace vt {
         SwapChainSupportDetails swapChainSupport = device.getSwapChainSupport();
 
         VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
-        VkPresentModeKHR presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
+        presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
         VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities);
 
-        uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
+        uint32_t imageCount = frameSettings.imageCount == 0
+            ? swapChainSupport.capabilities.minImageCount + 1
+            : std::max(frameSettings.imageCount, swapChainSupport.capabilities.minImageCount);
         if (swapChainSupport.capabilities.maxImageCount > 0 &&
             imageCount > swapChainSupport.capabilities.maxImageCount) {
             imageCount = swapChainSupport.capabilities.maxImageCount;
@@ -214,7 +301,7 @@ namespace vt {
 
     void VtSwapChain::createRenderPass() {
         VkAttachmentDescription depthAttachment{};
-        depthAttachment.format = findDepthFormat();
+        depthAttachment.format = swapChainDepthFormat;
         depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
         depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
         depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
@@ -274,9 +361,12 @@ namespace vt {
     }
 
     void VtSwapChain::createFramebuffers() {
-        swapChainFramebuffers.resize(imageCount());
-        for (size_t i = 0; i < imageCount(); i++) {
-            std::array<VkImageView, 2> attachments = { swapChainImageViews[i], depthImageViews[i] };
+        uint32_t framesInFlight = frameSettings.framesInFlight;
+        swapChainFramebuffers.resize(imageCount() * framesInFlight);
+        for (size_t i = 0; i < swapChainFramebuffers.size(); i++) {
+            std::array<VkImageView, 2> attachments = {
+                swapChainImageViews[i / framesInFlight],
+                depthAttachments->getView(static_cast<uint32_t>(i % framesInFlight)) };
 
             VkExtent2D swapChainExtent = getSwapChainExtent();
             VkFramebufferCreateInfo framebufferInfo = {};
@@ -299,58 +389,45 @@ namespace vt {
     }
 
     void VtSwapChain::createDepthResources() {
-        VkFormat depthFormat = findDepthFormat();
-        VkExtent2D swapChainExtent = getSwapChainExtent();
-
-        depthImages.resize(imageCount());
-        depthImageMemorys.resize(imageCount());
-        depthImageViews.resize(imageCount());
-
-        for (int i = 0; i < depthImages.size(); i++) {
-            VkImageCreateInfo imageInfo{};
-            imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-            imageInfo.imageType = VK_IMAGE_TYPE_2D;
-            imageInfo.extent.width = swapChainExtent.width;
-            imageInfo.extent.height = swapChainExtent.height;
-            imageInfo.extent.depth = 1;
-            imageInfo.mipLevels = 1;
-            imageInfo.arrayLayers = 1;
-            imageInfo.format = depthFormat;
-            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-            imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
-            imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-            imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-            imageInfo.flags = 0;
-
-            device.createImageWithInfo(
-                imageInfo,
-                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                depthImages[i],
-                depthImageMemorys[i]);
-
-            VkImageViewCreateInfo viewInfo{};
-            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-            viewInfo.image = depthImages[i];
-            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-            viewInfo.format = depthFormat;
-            viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-            viewInfo.subresourceRange.baseMipLevel = 0;
-            viewInfo.subresourceRange.levelCount = 1;
-            viewInfo.subresourceRange.baseArrayLayer = 0;
-            viewInfo.subresourceRange.layerCount = 1;
+        // Depth is cleared on load and never stored, so frames only need their own image while in flight.
+        depthAttachments = std::make_unique<VtDepthAttachments>(
+            device,
+            getSwapChainExtent(),
+            swapChainDepthFormat,
+            frameSettings.framesInFlight,
+            frameSettings.useTransientDepth);
+    }
 
-            if (vkCreateImageView(device.device(), &viewInfo, nullptr, &depthImageViews[i]) != VK_SUCCESS) {
-                throw std::runtime_error("failed to create texture image view!");
+    void VtSwapChain::createSyncObjects() {
+        // Presentation still needs binary semaphores, the timeline only replaces the fences.
+        if (frameSettings.useTimelineSemaphores) {
+            timeline = device.graphicsTimeline();
+            if (timeline == nullptr) {
+                std::cout << "Timeline semaphores unsupported, falling back to fences" << std::endl;
             }
         }
-    }
 
-    void VtSwapChain::createSyncObjects() {
-        imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-        renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-        inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
-        imagesInFlight.resize(imageCount(), VK_NULL_HANDLE);
+        // The semaphores are always new: a present that failed with the old chain may have left one signalled.
+        imageAvailableSemaphores.resize(frameSettings.framesInFlight);
+        renderFinishedSemaphores.resize(frameSettings.framesInFlight);
+        bool inheritFrames = oldSwapChain != nullptr && oldSwapChain->timeline == timeline;
+        if (inheritFrames) {
+            assert(oldSwapChain->frameSettings.framesInFlight == frameSettings.framesInFlight && "Recreated swap chain must keep its frames in flight");
+            frameValues = std::move(oldSwapChain->frameValues);
+            inFlightFences = std::move(oldSwapChain->inFlightFences);
+            oldSwapChain->frameValues.clear();
+            oldSwapChain->inFlightFences.clear();
+            currentFrame = oldSwapChain->currentFrame;
+            inheritFrameHistory(*oldSwapChain);
+        }
+        if (timeline != nullptr) {
+            frameValues.resize(frameSettings.framesInFlight, 0);
+            imageValues.resize(imageCount(), 0);
+        }
+        else {
+            inFlightFences.resize(frameSettings.framesInFlight, VK_NULL_HANDLE);
+            imagesInFlight.resize(imageCount(), VK_NULL_HANDLE);
+        }
 
         VkSemaphoreCreateInfo semaphoreInfo = {};
         semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -359,12 +436,20 @@ namespace vt {
         fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
         fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        // Per chain rather than inherited: each chain's destructor waits on the presents made with it.
+        if (device.supportsPresentFences()) {
+            presentFences.resize(frameSettings.framesInFlight, VK_NULL_HANDLE);
+        }
+
+        for (size_t i = 0; i < frameSettings.framesInFlight; i++) {
+            if (!presentFences.empty() && vkCreateFence(device.device(), &fenceInfo, nullptr, &presentFences[i]) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create synchronization objects for a frame!");
+            }
             if (vkCreateSemaphore(device.device(), &semaphoreInfo, nullptr, &imageAvailableSemaphores[i]) !=
                 VK_SUCCESS ||
                 vkCreateSemaphore(device.device(), &semaphoreInfo, nullptr, &renderFinishedSemaphores[i]) !=
                 VK_SUCCESS ||
-                vkCreateFence(device.device(), &fenceInfo, nullptr, &inFlightFences[i]) != VK_SUCCESS) {
+                (timeline == nullptr && !inheritFrames && vkCreateFence(device.device(), &fenceInfo, nullptr, &inFlightFences[i]) != VK_SUCCESS)) {
                 throw std::runtime_error("failed to create synchronization objects for a frame!");
             }
         }
@@ -385,20 +470,16 @@ namespace vt {
     VkPresentModeKHR VtSwapChain::chooseSwapPresentMode(
         const std::vector<VkPresentModeKHR>& availablePresentModes) {
         for (const auto& availablePresentMode : availablePresentModes) {
-            if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
-                std::cout << "Present mode: Mailbox" << std::endl;
+            if (availablePresentMode == frameSettings.presentMode) {
+                std::cout << "Present mode: " << presentModeName(availablePresentMode) << std::endl;
                 return availablePresentMode;
             }
         }
 
-        // for (const auto &availablePresentMode : availablePresentModes) {
-        //   if (availablePresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR) {
-        //     std::cout << "Present mode: Immediate" << std::endl;
-        //     return availablePresentMode;
-        //   }
-        // }
-
-        std::cout << "Present mode: V-Sync" << std::endl;
+        if (frameSettings.presentMode != VK_PRESENT_MODE_FIFO_KHR) {
+            std::cout << "Present mode " << presentModeName(frameSettings.presentMode) << " unsupported, falling back" << std::endl;
+        }
+        std::cout << "Present mode: " << presentModeName(VK_PRESENT_MODE_FIFO_KHR) << std::endl;
         return VK_PRESENT_MODE_FIFO_KHR;
     }
 
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "vt_depth_attachments.h"
 #include "vt_device.h"
+#include "vt_render_target.h"
 
 //vulkan
 #include <vulkan/vulkan.h>
@@ -12,23 +14,32 @@
 
 namespace vt {
 
-    class VtSwapChain {
+    class VtSwapChain : public VtRenderTarget {
     public:
-        static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
-
-        VtSwapChain(VtDevice& deviceRef, VkExtent2D windowExtent);
-        VtSwapChain(VtDevice& deviceRef, VkExtent2D windowExtent, std::shared_ptr<VtSwapChain> _previous);
-        ~VtSwapChain();
+        VtSwapChain(VtDevice& deviceRef, VkExtent2D windowExtent, const VtFrameSettings& _settings = {});
+        // Hands _previous over as oldSwapchain and takes over its frame slots: their fences or timeline
+        // values keep pacing the frame index, so frames recorded before the resize stay guarded. _previous
+        // still owns its images, framebuffers and depth, which frames up to getSubmittedFrameCount() may
+        // use; destroy it once they have retired, see VtDeletionQueue. Retired frames do not prove their
+        // presents are done, so the destructor waits for those itself, see waitForPresents.
+        VtSwapChain(VtDevice& deviceRef, VkExtent2D windowExtent, std::shared_ptr<VtSwapChain> _previous, const VtFrameSettings& _settings = {});
+        ~VtSwapChain() override;
 
         VtSwapChain(const VtSwapChain&) = delete;
         VtSwapChain& operator=(const VtSwapChain&) = delete;
 
-        VkFramebuffer getFrameBuffer(int index) { return swapChainFramebuffers[index]; }
-        VkRenderPass getRenderPass() { return renderPass; }
+        VkFramebuffer getFrameBuffer(int index) override {
+            return swapChainFramebuffers[index * frameSettings.framesInFlight + currentFrame];
+        }
+        VkRenderPass getRenderPass() override { return renderPass; }
         VkImageView getImageView(int index) { return swapChainImageViews[index]; }
-        size_t imageCount() { return swapChainImages.size(); }
+        size_t imageCount() override { return swapChainImages.size(); }
         VkFormat getSwapChainImageFormat() { return swapChainImageFormat; }
         VkExtent2D getSwapChainExtent() { return swapChainExtent; }
+        VkExtent2D getExtent() override { return swapChainExtent; }
+        uint32_t getCurrentFrame() override { return static_cast<uint32_t>(currentFrame); }
+        uint32_t framesInFlight() override { return frameSettings.framesInFlight; }
+        VkPresentModeKHR getPresentMode() { return presentMode; }
         uint32_t width() { return swapChainExtent.width; }
         uint32_t height() { return swapChainExtent.height; }
 
@@ -37,10 +48,19 @@ namespace vt {
         }
         VkFormat findDepthFormat();
 
-        VkResult acquireNextImage(uint32_t* imageIndex);
-        VkResult submitCommandBuffers(const VkCommandBuffer* buffers, uint32_t* imageIndex);
+        bool compareSwapFormats(const VtSwapChain& _swapChain) const {
+            return _swapChain.swapChainImageFormat == swapChainImageFormat &&
+                _swapChain.swapChainDepthFormat == swapChainDepthFormat;
+        }
+
+        VkResult acquireNextImage(uint32_t* imageIndex) override;
+        VkResult submitCommandBuffers(const VkCommandBuffer* buffers, uint32_t* imageIndex) override;
 
     private:
+        // Blocks until the presentation engine has released every semaphore and image this chain
+        // presented: on its present fences where the device has VK_EXT_swapchain_maintenance1, otherwise
+        // by idling the present queue alone.
+        void waitForPresents();
         void init();
         void createSwapChain();
         void createImageViews();
@@ -57,19 +77,21 @@ namespace vt {
         VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities);
 
         VkFormat swapChainImageFormat;
+        VkFormat swapChainDepthFormat;
         VkExtent2D swapChainExtent;
 
+        // One per swap chain image and frame in flight, indexed image * framesInFlight + frame.
         std::vector<VkFramebuffer> swapChainFramebuffers;
         VkRenderPass renderPass;
 
-        std::vector<VkImage> depthImages;
-        std::vector<VkDeviceMemory> depthImageMemorys;
-        std::vector<VkImageView> depthImageViews;
+        std::unique_ptr<VtDepthAttachments> depthAttachments;
         std::vector<VkImage> swapChainImages;
         std::vector<VkImageView> swapChainImageViews;
 
         VtDevice& device;
         VkExtent2D windowExtent;
+        VtFrameSettings frameSettings;
+        VkPresentModeKHR presentMode;
 
         VkSwapchainKHR swapChain;
         std::shared_ptr<VtSwapChain> oldSwapChain;
@@ -78,7 +100,15 @@ namespace vt {
         std::vector<VkSemaphore> renderFinishedSemaphores;
         std::vector<VkFence> inFlightFences;
         std::vector<VkFence> imagesInFlight;
+        // One per frame slot, signalled when that slot's last present is done; empty without present fences.
+        std::vector<VkFence> presentFences;
+        bool hasPresented = false;
         size_t currentFrame = 0;
+
+        // Timeline mode: the graphics timeline value each frame slot and each image was last submitted with.
+        VtTimeline* timeline = nullptr;
+        std::vector<uint64_t> frameValues;
+        std::vector<uint64_t> imageValues;
     };
 
 }  // namespace lve
@@ -0,0 +1,57 @@
+#include "vt_timeline.h"
+
+//std
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+
+namespace vt {
+
+    VtTimeline::VtTimeline(VkDevice _device) : device{ _device } {
+        VkSemaphoreTypeCreateInfo typeInfo{};
+        typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext = &typeInfo;
+
+        if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create timeline semaphore!");
+        }
+    }
+
+    VtTimeline::~VtTimeline() {
+        vkDestroySemaphore(device, semaphore, nullptr);
+    }
+
+    bool VtTimeline::isRetired(uint64_t _value) {
+        assert(_value <= lastSubmitted && "Value was never submitted");
+
+        if (_value <= completed) {
+            return true;
+        }
+        if (vkGetSemaphoreCounterValue(device, semaphore, &completed) != VK_SUCCESS) {
+            throw std::runtime_error("failed to read timeline semaphore!");
+        }
+        return _value <= completed;
+    }
+
+    void VtTimeline::wait(uint64_t _value) {
+        if (isRetired(_value)) {
+            return;
+        }
+
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &semaphore;
+        waitInfo.pValues = &_value;
+
+        if (vkWaitSemaphores(device, &waitInfo, std::numeric_limits<uint64_t>::max()) != VK_SUCCESS) {
+            throw std::runtime_error("failed to wait for timeline semaphore!");
+        }
+        completed = _value;
+    }
+}
\ No newline at end of file
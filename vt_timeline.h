@@ -0,0 +1,38 @@
+#pragma once
+
+//vulkan
+#include <vulkan/vulkan.h>
+
+//std
+#include <cstdint>
+
+namespace vt {
+
+    // A timeline semaphore counting the frames submitted to one queue. Every submission signals the
+    // next value, so "has frame N retired?" is a comparison against the counter instead of a fence
+    // per frame. Values are only handed out and waited on from the thread that submits frames.
+    class VtTimeline {
+    public:
+        explicit VtTimeline(VkDevice _device);
+        ~VtTimeline();
+
+        VtTimeline(const VtTimeline&) = delete;
+        VtTimeline& operator=(const VtTimeline&) = delete;
+
+        VkSemaphore handle() const { return semaphore; }
+
+        // Reserves the value the next submission signals.
+        uint64_t advance() { return ++lastSubmitted; }
+        uint64_t lastSubmittedValue() const { return lastSubmitted; }
+
+        // Answers from the last counter value seen and only asks the driver when that is behind.
+        bool isRetired(uint64_t _value);
+        void wait(uint64_t _value);
+
+    private:
+        VkDevice device;
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+        uint64_t lastSubmitted = 0;
+        uint64_t completed = 0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,247 @@
+#include "vt_upload_context.h"
+
+//std
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+namespace vt {
+
+    VtUploadContext::VtUploadContext(VkDevice _device, VkQueue _queue, std::mutex& _queueMutex, uint32_t _queueFamilyIndex)
+        : device{ _device }, queue{ _queue }, queueMutex{ _queueMutex } {
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = _queueFamilyIndex;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create upload command pool!");
+        }
+    }
+
+    VtUploadContext::~VtUploadContext() {
+        waitIdle();
+
+        for (auto& batch : freeBatches) {
+            vkDestroyFence(device, batch->fence, nullptr);
+        }
+        vkDestroyCommandPool(device, commandPool, nullptr);
+    }
+
+    VtUploadTicket VtUploadContext::record(const std::function<void(VkCommandBuffer)>& _commands) {
+        std::lock_guard<std::mutex> lock{ mutex };
+
+        if (pending == nullptr) {
+            pending = acquireBatch();
+
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            vkBeginCommandBuffer(pending->commandBuffer, &beginInfo);
+        }
+
+        _commands(pending->commandBuffer);
+        return { pending->id };
+    }
+
+    VtUploadTicket VtUploadContext::flush() {
+        std::lock_guard<std::mutex> lock{ mutex };
+
+        // With nothing open the ticket is the last batch submitted, which retires after every earlier one.
+        uint64_t id = pending != nullptr ? pending->id : submittedBatchId;
+        submitPending();
+        return { id };
+    }
+
+    bool VtUploadContext::isComplete(VtUploadTicket _ticket) {
+        std::vector<std::function<void()>> callbacks;
+        bool complete;
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+
+            if (pending != nullptr && pending->id == _ticket.value) {
+                submitPending();
+            }
+
+            retireFinished(callbacks);
+            complete = _ticket.value <= retiredBatchId;
+        }
+
+        for (auto& callback : callbacks) {
+            callback();
+        }
+        return complete;
+    }
+
+    void VtUploadContext::wait(VtUploadTicket _ticket) {
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+
+            if (pending != nullptr && pending->id == _ticket.value) {
+                submitPending();
+            }
+        }
+
+        waitForBatch(_ticket.value);
+    }
+
+    void VtUploadContext::waitIdle() {
+        uint64_t lastSubmitted;
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            submitPending();
+            lastSubmitted = submittedBatchId;
+        }
+
+        waitForBatch(lastSubmitted);
+    }
+
+    void VtUploadContext::onComplete(VtUploadTicket _ticket, std::function<void()> _callback) {
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+
+            if (pending != nullptr && pending->id == _ticket.value) {
+                pending->callbacks.push_back(std::move(_callback));
+                return;
+            }
+
+            Batch* batch = findInFlight(_ticket.value);
+            if (batch != nullptr) {
+                batch->callbacks.push_back(std::move(_callback));
+                return;
+            }
+        }
+
+        // Already retired.
+        _callback();
+    }
+
+    void VtUploadContext::collect() {
+        std::vector<std::function<void()>> callbacks;
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            retireFinished(callbacks);
+        }
+
+        for (auto& callback : callbacks) {
+            callback();
+        }
+    }
+
+    std::unique_ptr<VtUploadContext::Batch> VtUploadContext::acquireBatch() {
+        std::unique_ptr<Batch> batch;
+
+        // A retired batch may still have a thread waiting on its fence, which must not be reset under it.
+        auto reusable = std::find_if(freeBatches.rbegin(), freeBatches.rend(), [](const std::unique_ptr<Batch>& _batch) {
+            return _batch->waiters == 0;
+        });
+        if (reusable != freeBatches.rend()) {
+            batch = std::move(*reusable);
+            freeBatches.erase(std::next(reusable).base());
+            vkResetCommandBuffer(batch->commandBuffer, 0);
+            vkResetFences(device, 1, &batch->fence);
+        }
+        else {
+            batch = std::make_unique<Batch>();
+
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandPool = commandPool;
+            allocInfo.commandBufferCount = 1;
+
+            VkFenceCreateInfo fenceInfo{};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+            if (vkAllocateCommandBuffers(device, &allocInfo, &batch->commandBuffer) != VK_SUCCESS ||
+                vkCreateFence(device, &fenceInfo, nullptr, &batch->fence) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create upload batch!");
+            }
+        }
+
+        batch->id = nextBatchId++;
+        return batch;
+    }
+
+    void VtUploadContext::submitPending() {
+        if (pending == nullptr) {
+            return;
+        }
+
+        vkEndCommandBuffer(pending->commandBuffer);
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &pending->commandBuffer;
+
+        VkResult result;
+        {
+            std::lock_guard<std::mutex> queueLock{ queueMutex };
+            result = vkQueueSubmit(queue, 1, &submitInfo, pending->fence);
+        }
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error("failed to submit upload batch!");
+        }
+
+        submittedBatchId = pending->id;
+        inFlight.push_back(std::move(pending));
+    }
+
+    VtUploadContext::Batch* VtUploadContext::findInFlight(uint64_t _id) {
+        for (auto& batch : inFlight) {
+            if (batch->id == _id) {
+                return batch.get();
+            }
+        }
+        return nullptr;
+    }
+
+    void VtUploadContext::waitForBatch(uint64_t _id) {
+        std::vector<std::function<void()>> callbacks;
+        while (true) {
+            Batch* oldest;
+            {
+                std::lock_guard<std::mutex> lock{ mutex };
+                retireFinished(callbacks);
+                if (_id <= retiredBatchId || inFlight.empty()) {
+                    break;
+                }
+                // Batches retire in order, so waiting on the oldest one never spins on a later fence.
+                oldest = inFlight.front().get();
+                oldest->waiters++;
+            }
+
+            vkWaitForFences(device, 1, &oldest->fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+
+            std::lock_guard<std::mutex> lock{ mutex };
+            oldest->waiters--;
+        }
+
+        for (auto& callback : callbacks) {
+            callback();
+        }
+    }
+
+    void VtUploadContext::retireFinished(std::vector<std::function<void()>>& _callbacks) {
+        // Batches are retired strictly in submission order so retiredBatchId can stand in for all earlier tickets.
+        while (!inFlight.empty()) {
+            auto& batch = inFlight.front();
+
+            if (vkGetFenceStatus(device, batch->fence) != VK_SUCCESS) {
+                break;
+            }
+
+            for (auto& callback : batch->callbacks) {
+                _callbacks.push_back(std::move(callback));
+            }
+            batch->callbacks.clear();
+
+            retiredBatchId = batch->id;
+            freeBatches.push_back(std::move(batch));
+            inFlight.pop_front();
+        }
+    }
+}
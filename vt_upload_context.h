@@ -0,0 +1,76 @@
+#pragma once
+
+//vulkan
+#include <vulkan/vulkan.h>
+
+//std
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vt {
+
+    // Identifies the batch a copy was recorded into. A default ticket is always complete.
+    struct VtUploadTicket {
+        uint64_t value = 0;
+    };
+
+    // Records copies from any thread into one open command buffer and submits them as a single batch,
+    // signalling a fence instead of idling the queue. Runs on the dedicated transfer queue when the
+    // device has one, otherwise on the graphics queue, which is why submits take the queue's mutex.
+    class VtUploadContext {
+    public:
+        // _queueMutex is held around every submit to _queue, see VtDevice::queueMutex.
+        VtUploadContext(VkDevice _device, VkQueue _queue, std::mutex& _queueMutex, uint32_t _queueFamilyIndex);
+        ~VtUploadContext();
+
+        VtUploadContext(const VtUploadContext&) = delete;
+        VtUploadContext& operator=(const VtUploadContext&) = delete;
+
+        VtUploadTicket record(const std::function<void(VkCommandBuffer)>& _commands);
+        VtUploadTicket flush();
+
+        bool isComplete(VtUploadTicket _ticket);
+        void wait(VtUploadTicket _ticket);
+        void waitIdle();
+
+        // Runs _callback once the ticket's batch has retired, e.g. to release a staging buffer.
+        void onComplete(VtUploadTicket _ticket, std::function<void()> _callback);
+
+        // Retires finished batches and recycles their command buffers. Cheap, call once per frame.
+        void collect();
+
+    private:
+        struct Batch {
+            uint64_t id = 0;
+            VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+            VkFence fence = VK_NULL_HANDLE;
+            std::vector<std::function<void()>> callbacks;
+            // Threads waiting on the fence outside the mutex; the batch is not recycled until they are done.
+            uint32_t waiters = 0;
+        };
+
+        std::unique_ptr<Batch> acquireBatch();
+        void submitPending();
+        Batch* findInFlight(uint64_t _id);
+        void retireFinished(std::vector<std::function<void()>>& _callbacks);
+        // Blocks until batch _id has retired, without holding the mutex while the GPU works.
+        void waitForBatch(uint64_t _id);
+
+        VkDevice device;
+        VkQueue queue;
+        std::mutex& queueMutex;
+        VkCommandPool commandPool;
+
+        uint64_t nextBatchId = 1;
+        uint64_t submittedBatchId = 0;
+        uint64_t retiredBatchId = 0;
+
+        std::unique_ptr<Batch> pending;
+        std::deque<std::unique_ptr<Batch>> inFlight;
+        std::vector<std::unique_ptr<Batch>> freeBatches;
+        std::mutex mutex;
+    };
+}
@@ -0,0 +1,74 @@
+#include "vt_vertex_format.h"
+
+//std
+#include <algorithm>
+#include <cmath>
+
+namespace vt {
+
+    namespace {
+
+        int16_t encodeSnorm16(float _value) {
+            return static_cast<int16_t>(std::lround(std::clamp(_value, -1.0f, 1.0f) * 32767.0f));
+        }
+
+        uint8_t encodeUnorm8(float _value) {
+            return static_cast<uint8_t>(std::lround(std::clamp(_value, 0.0f, 1.0f) * 255.0f));
+        }
+    }
+
+    VtSnorm16x2 VtSnorm16x2::encode(glm::vec2 _value) {
+        return { encodeSnorm16(_value.x), encodeSnorm16(_value.y) };
+    }
+
+    VtHalf2 VtHalf2::encode(glm::vec2 _value) {
+        return { floatToHalf(_value.x), floatToHalf(_value.y) };
+    }
+
+    VtUnorm8x4 VtUnorm8x4::encode(glm::vec3 _value) {
+        return { encodeUnorm8(_value.x), encodeUnorm8(_value.y), encodeUnorm8(_value.z), 255 };
+    }
+
+    uint16_t floatToHalf(float _value) {
+        uint32_t bits;
+        memcpy(&bits, &_value, sizeof(bits));
+
+        uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+        uint32_t exponent = (bits >> 23) & 0xffu;
+        uint32_t mantissa = bits & 0x7fffffu;
+
+        // Infinity stays infinity, NaN stays a quiet NaN.
+        if (exponent == 0xffu) {
+            return static_cast<uint16_t>(sign | 0x7c00u | (mantissa != 0 ? 0x200u : 0u));
+        }
+
+        int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+        if (halfExponent >= 0x1f) {
+            return static_cast<uint16_t>(sign | 0x7c00u);
+        }
+
+        if (halfExponent <= 0) {
+            // Subnormal or zero: shift the mantissa, with its implicit leading one, into place.
+            if (halfExponent < -10) {
+                return sign;
+            }
+            mantissa |= 0x800000u;
+            uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+            uint32_t half = mantissa >> shift;
+            uint32_t remainder = mantissa & ((1u << shift) - 1u);
+            uint32_t halfway = 1u << (shift - 1u);
+            if (remainder > halfway || (remainder == halfway && (half & 1u) != 0)) {
+                half++;
+            }
+            return static_cast<uint16_t>(sign | half);
+        }
+
+        // Rounding can carry into the exponent, which correctly rounds the largest values up to infinity.
+        uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+        uint32_t remainder = mantissa & 0x1fffu;
+        if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u) != 0)) {
+            half++;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "vt_vertex_input.h"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+//vulkan
+#include <vulkan/vulkan.h>
+
+//std
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace vt {
+
+    // Attribute storage types. Each names the format the vertex fetch decodes it with and encodes itself
+    // from the float value models are authored in, so shaders keep reading plain vec2/vec3 inputs.
+
+    struct VtFloat2 {
+        static constexpr VkFormat FORMAT = VK_FORMAT_R32G32_SFLOAT;
+        float x, y;
+        static VtFloat2 encode(glm::vec2 _value) { return { _value.x, _value.y }; }
+    };
+
+    struct VtFloat3 {
+        static constexpr VkFormat FORMAT = VK_FORMAT_R32G32B32_SFLOAT;
+        float x, y, z;
+        static VtFloat3 encode(glm::vec3 _value) { return { _value.x, _value.y, _value.z }; }
+    };
+
+    // Fixed point in [-1, 1]; values outside are clamped.
+    struct VtSnorm16x2 {
+        static constexpr VkFormat FORMAT = VK_FORMAT_R16G16_SNORM;
+        int16_t x, y;
+        static VtSnorm16x2 encode(glm::vec2 _value);
+    };
+
+    struct VtHalf2 {
+        static constexpr VkFormat FORMAT = VK_FORMAT_R16G16_SFLOAT;
+        uint16_t x, y;
+        static VtHalf2 encode(glm::vec2 _value);
+    };
+
+    // Colour in [0, 1] with an opaque alpha the shader does not read.
+    struct VtUnorm8x4 {
+        static constexpr VkFormat FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+        uint8_t r, g, b, a;
+        static VtUnorm8x4 encode(glm::vec3 _value);
+    };
+
+    // Round to nearest even IEEE 754 binary16, with overflow to infinity and subnormals kept.
+    uint16_t floatToHalf(float _value);
+
+    // A vertex stored as a position and a colour attribute, at locations 0 and 1 of binding 0 like
+    // VtModel::Vertex. The attribute formats follow from the member types.
+    template <typename PositionFormat, typename ColourFormat>
+    struct VtVertexLayout {
+        using Position = PositionFormat;
+        using Colour = ColourFormat;
+
+        PositionFormat position;
+        ColourFormat colour;
+
+        static VtVertexLayout encode(glm::vec2 _position, glm::vec3 _colour) {
+            return { PositionFormat::encode(_position), ColourFormat::encode(_colour) };
+        }
+    };
+
+    template <typename PositionFormat, typename ColourFormat>
+    struct VtVertexInputTraits<VtVertexLayout<PositionFormat, ColourFormat>> {
+        using Layout = VtVertexLayout<PositionFormat, ColourFormat>;
+
+        static constexpr std::array<VkVertexInputBindingDescription, 1> bindings{ {
+            { 0, sizeof(Layout), VK_VERTEX_INPUT_RATE_VERTEX },
+        } };
+        static constexpr std::array<VkVertexInputAttributeDescription, 2> attributes{ {
+            { 0, 0, PositionFormat::FORMAT, offsetof(Layout, position) },
+            { 1, 0, ColourFormat::FORMAT, offsetof(Layout, colour) },
+        } };
+    };
+
+    using VtFloatVertex = VtVertexLayout<VtFloat2, VtFloat3>;
+    using VtSnorm16Vertex = VtVertexLayout<VtSnorm16x2, VtUnorm8x4>;
+    using VtHalfVertex = VtVertexLayout<VtHalf2, VtUnorm8x4>;
+
+    static_assert(sizeof(VtFloatVertex) == 20, "Float vertices must stay tightly packed");
+    static_assert(sizeof(VtSnorm16Vertex) == 8, "Snorm16 vertices must stay tightly packed");
+    static_assert(sizeof(VtHalfVertex) == 8, "Half vertices must stay tightly packed");
+
+    // Runtime choice between the layouts above.
+    enum class VtVertexFormat { Float, Snorm16, Half };
+
+    // Calls _visitor with a default constructed value of _format's layout type and returns its result.
+    template <typename Visitor>
+    decltype(auto) visitVertexFormat(VtVertexFormat _format, Visitor&& _visitor) {
+        switch (_format) {
+        case VtVertexFormat::Snorm16:
+            return _visitor(VtSnorm16Vertex{});
+        case VtVertexFormat::Half:
+            return _visitor(VtHalfVertex{});
+        default:
+            return _visitor(VtFloatVertex{});
+        }
+    }
+
+    // Encodes _count vertices, read through the position and colour accessors, into tightly packed bytes.
+    template <typename Layout, typename GetPosition, typename GetColour>
+    std::vector<uint8_t> encodeVertices(size_t _count, GetPosition&& _position, GetColour&& _colour) {
+        static_assert(std::is_trivially_copyable<Layout>::value, "Vertex layouts are copied into buffers byte by byte");
+
+        std::vector<uint8_t> bytes(sizeof(Layout) * _count);
+        for (size_t i = 0; i < _count; i++) {
+            Layout vertex = Layout::encode(_position(i), _colour(i));
+            memcpy(bytes.data() + sizeof(Layout) * i, &vertex, sizeof(Layout));
+        }
+        return bytes;
+    }
+
+    inline size_t vertexStride(VtVertexFormat _format) {
+        return visitVertexFormat(_format, [](auto _layout) { return sizeof(_layout); });
+    }
+
+    inline const char* vertexFormatName(VtVertexFormat _format) {
+        switch (_format) {
+        case VtVertexFormat::Snorm16: return "snorm16";
+        case VtVertexFormat::Half: return "half";
+        default: return "float";
+        }
+    }
+
+    // Accepts the names vertexFormatName produces; leaves _format untouched and returns false otherwise.
+    inline bool parseVertexFormat(const char* _name, VtVertexFormat& _format) {
+        for (VtVertexFormat format : { VtVertexFormat::Float, VtVertexFormat::Snorm16, VtVertexFormat::Half }) {
+            if (strcmp(_name, vertexFormatName(format)) == 0) {
+                _format = format;
+                return true;
+            }
+        }
+        return false;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+//vulkan
+#include <vulkan/vulkan.h>
+
+//std
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+namespace vt {
+
+    // Compile-time description of one vertex input stream. Specialise it next to the vertex type with
+    // constexpr arrays of the stream's bindings and attributes:
+    //
+    //     template <> struct VtVertexInputTraits<MyVertex> {
+    //         static constexpr std::array<VkVertexInputBindingDescription, 1> bindings{ ... };
+    //         static constexpr std::array<VkVertexInputAttributeDescription, 2> attributes{ ... };
+    //     };
+    template <typename T>
+    struct VtVertexInputTraits;
+
+    // Vertex input state of a pipeline, stored inline so describing and copying it never allocates.
+    struct VtVertexInput {
+        static constexpr uint32_t MAX_BINDINGS = 4;
+        static constexpr uint32_t MAX_ATTRIBUTES = 8;
+
+        std::array<VkVertexInputBindingDescription, MAX_BINDINGS> bindings{};
+        std::array<VkVertexInputAttributeDescription, MAX_ATTRIBUTES> attributes{};
+        uint32_t bindingCount = 0;
+        uint32_t attributeCount = 0;
+
+        // Appends the stream VtVertexInputTraits<T> describes.
+        template <typename T>
+        constexpr VtVertexInput& add() {
+            using Traits = VtVertexInputTraits<T>;
+            for (const auto& binding : Traits::bindings) {
+                assert(bindingCount < MAX_BINDINGS && "Too many vertex input bindings");
+                bindings[bindingCount++] = binding;
+            }
+            for (const auto& attribute : Traits::attributes) {
+                assert(attributeCount < MAX_ATTRIBUTES && "Too many vertex input attributes");
+                attributes[attributeCount++] = attribute;
+            }
+            return *this;
+        }
+    };
+
+    template <typename... Streams>
+    constexpr VtVertexInput makeVertexInput() {
+        VtVertexInput input{};
+        (input.add<Streams>(), ...);
+        return input;
+    }
+
+    // The streams' vertex input, in order, built while compiling: exceeding the capacity fails the build.
+    template <typename... Streams>
+    inline constexpr VtVertexInput vertexInputOf = makeVertexInput<Streams...>();
+}
\ No newline at end of file
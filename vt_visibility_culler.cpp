@@ -0,0 +1,177 @@
+#include "vt_visibility_culler.h"
+
+//std
+#include <cassert>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define VT_CULLING_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC accepts AVX intrinsics in any function, GCC and Clang only in ones compiled for the target.
+#define VT_TARGET_AVX
+#else
+#define VT_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+namespace vt {
+
+    namespace {
+
+#if VT_CULLING_X86
+        bool cpuHasAvx() {
+#if defined(_MSC_VER)
+            // AVX needs the CPU flag and an OS that saves the YMM registers (OSXSAVE plus XCR0 bits 1 and 2).
+            int info[4];
+            __cpuid(info, 1);
+            bool avx = (info[2] & (1 << 28)) != 0;
+            bool osxsave = (info[2] & (1 << 27)) != 0;
+            return avx && osxsave && (_xgetbv(0) & 0x6) == 0x6;
+#else
+            return __builtin_cpu_supports("avx");
+#endif
+        }
+
+        // Appends the index of every set bit of _mask, counting from _base.
+        inline uint32_t appendMask(uint32_t* _visible, uint32_t _visibleCount, uint32_t _base, uint32_t _mask) {
+            while (_mask != 0) {
+#if defined(_MSC_VER)
+                unsigned long bit;
+                _BitScanForward(&bit, _mask);
+#else
+                uint32_t bit = static_cast<uint32_t>(__builtin_ctz(_mask));
+#endif
+                _visible[_visibleCount++] = _base + bit;
+                _mask &= _mask - 1;
+            }
+            return _visibleCount;
+        }
+#endif
+    }
+
+    VtVisibilityCuller::VtVisibilityCuller() {
+        if (isSupported(Kernel::Avx)) {
+            kernel = Kernel::Avx;
+        }
+        else if (isSupported(Kernel::Sse2)) {
+            kernel = Kernel::Sse2;
+        }
+    }
+
+    bool VtVisibilityCuller::isSupported(Kernel _kernel) {
+        switch (_kernel) {
+        case Kernel::Scalar:
+            return true;
+#if VT_CULLING_X86
+        case Kernel::Sse2:
+            return true;
+        case Kernel::Avx:
+            return cpuHasAvx();
+#endif
+        default:
+            return false;
+        }
+    }
+
+    const char* VtVisibilityCuller::kernelName(Kernel _kernel) {
+        switch (_kernel) {
+        case Kernel::Scalar: return "scalar";
+        case Kernel::Sse2: return "sse2";
+        case Kernel::Avx: return "avx";
+        }
+        return "unknown";
+    }
+
+    void VtVisibilityCuller::setKernel(Kernel _kernel) {
+        assert(isSupported(_kernel) && "Culling kernel is not supported on this CPU");
+        kernel = _kernel;
+    }
+
+    void VtVisibilityCuller::resize(uint32_t _count) {
+        // Empty bounds fail every overlap test against a finite view, padding included.
+        constexpr float infinity = std::numeric_limits<float>::infinity();
+        size_t padded = (static_cast<size_t>(_count) + LANES - 1) / LANES * LANES;
+
+        for (uint32_t i = _count; i < count; i++) {
+            setBounds(i, glm::vec2{ infinity }, glm::vec2{ -infinity });
+        }
+        minX.resize(padded, infinity);
+        minY.resize(padded, infinity);
+        maxX.resize(padded, -infinity);
+        maxY.resize(padded, -infinity);
+        visible.resize(padded);
+        count = _count;
+        visibleCount = 0;
+    }
+
+    uint32_t VtVisibilityCuller::cull(const Rect& _view) {
+        switch (kernel) {
+        case Kernel::Sse2:
+            visibleCount = cullSse2(_view);
+            break;
+        case Kernel::Avx:
+            visibleCount = cullAvx(_view);
+            break;
+        default:
+            visibleCount = cullScalar(_view);
+            break;
+        }
+        return visibleCount;
+    }
+
+    uint32_t VtVisibilityCuller::cullScalar(const Rect& _view) {
+        // Branchless: always store the index, only advance past it when the object is visible.
+        uint32_t result = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t inside = static_cast<uint32_t>(minX[i] <= _view.max.x) & static_cast<uint32_t>(maxX[i] >= _view.min.x)
+                & static_cast<uint32_t>(minY[i] <= _view.max.y) & static_cast<uint32_t>(maxY[i] >= _view.min.y);
+            visible[result] = i;
+            result += inside;
+        }
+        return result;
+    }
+
+#if VT_CULLING_X86
+    uint32_t VtVisibilityCuller::cullSse2(const Rect& _view) {
+        const __m128 viewMinX = _mm_set1_ps(_view.min.x);
+        const __m128 viewMinY = _mm_set1_ps(_view.min.y);
+        const __m128 viewMaxX = _mm_set1_ps(_view.max.x);
+        const __m128 viewMaxY = _mm_set1_ps(_view.max.y);
+
+        uint32_t result = 0;
+        for (uint32_t i = 0; i < count; i += 4) {
+            __m128 inside = _mm_and_ps(
+                _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&minX[i]), viewMaxX), _mm_cmpge_ps(_mm_loadu_ps(&maxX[i]), viewMinX)),
+                _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&minY[i]), viewMaxY), _mm_cmpge_ps(_mm_loadu_ps(&maxY[i]), viewMinY)));
+            result = appendMask(visible.data(), result, i, static_cast<uint32_t>(_mm_movemask_ps(inside)));
+        }
+        return result;
+    }
+
+    VT_TARGET_AVX uint32_t VtVisibilityCuller::cullAvx(const Rect& _view) {
+        const __m256 viewMinX = _mm256_set1_ps(_view.min.x);
+        const __m256 viewMinY = _mm256_set1_ps(_view.min.y);
+        const __m256 viewMaxX = _mm256_set1_ps(_view.max.x);
+        const __m256 viewMaxY = _mm256_set1_ps(_view.max.y);
+
+        uint32_t result = 0;
+        for (uint32_t i = 0; i < count; i += 8) {
+            __m256 inside = _mm256_and_ps(
+                _mm256_and_ps(
+                    _mm256_cmp_ps(_mm256_loadu_ps(&minX[i]), viewMaxX, _CMP_LE_OQ),
+                    _mm256_cmp_ps(_mm256_loadu_ps(&maxX[i]), viewMinX, _CMP_GE_OQ)),
+                _mm256_and_ps(
+                    _mm256_cmp_ps(_mm256_loadu_ps(&minY[i]), viewMaxY, _CMP_LE_OQ),
+                    _mm256_cmp_ps(_mm256_loadu_ps(&maxY[i]), viewMinY, _CMP_GE_OQ)));
+            result = appendMask(visible.data(), result, i, static_cast<uint32_t>(_mm256_movemask_ps(inside)));
+        }
+        return result;
+    }
+#else
+    // Without x86 intrinsics isSupported() rejects the SIMD kernels, so these are never selected.
+    uint32_t VtVisibilityCuller::cullSse2(const Rect& _view) { return cullScalar(_view); }
+    uint32_t VtVisibilityCuller::cullAvx(const Rect& _view) { return cullScalar(_view); }
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+//std
+#include <cstdint>
+#include <vector>
+
+namespace vt {
+
+    // CPU visibility culling of many 2D bounding rectangles against a view rectangle. Bounds are kept
+    // as one array per component so the SSE2 and AVX kernels test four or eight objects with a single
+    // compare; the result is a compacted list of the visible indices in ascending order.
+    class VtVisibilityCuller {
+    public:
+        enum class Kernel { Scalar, Sse2, Avx };
+
+        struct Rect {
+            glm::vec2 min;
+            glm::vec2 max;
+        };
+
+        // Starts with the widest kernel the CPU supports.
+        VtVisibilityCuller();
+
+        static bool isSupported(Kernel _kernel);
+        static const char* kernelName(Kernel _kernel);
+
+        void setKernel(Kernel _kernel);
+        Kernel getKernel() const { return kernel; }
+
+        // New objects start out empty and are never visible until their bounds are set.
+        void resize(uint32_t _count);
+        uint32_t size() const { return count; }
+
+        void setBounds(uint32_t _index, glm::vec2 _min, glm::vec2 _max) {
+            minX[_index] = _min.x;
+            minY[_index] = _min.y;
+            maxX[_index] = _max.x;
+            maxY[_index] = _max.y;
+        }
+
+        // Collects the objects overlapping _view, edges included, and returns how many there are.
+        uint32_t cull(const Rect& _view);
+        const uint32_t* getVisible() const { return visible.data(); }
+        uint32_t getVisibleCount() const { return visibleCount; }
+
+    private:
+        // Arrays are padded to a whole AVX register of empty bounds, so kernels never need a tail loop.
+        static constexpr uint32_t LANES = 8;
+
+        uint32_t cullScalar(const Rect& _view);
+        uint32_t cullSse2(const Rect& _view);
+        uint32_t cullAvx(const Rect& _view);
+
+        Kernel kernel = Kernel::Scalar;
+        uint32_t count = 0;
+        std::vector<float> minX;
+        std::vector<float> minY;
+        std::vector<float> maxX;
+        std::vector<float> maxY;
+        std::vector<uint32_t> visible;
+        uint32_t visibleCount = 0;
+    };
+}
\ No newline at end of file